@@ -0,0 +1,161 @@
+/* Disk Scheduling Engine */
+#ifndef DISK_SCHED_H
+#define DISK_SCHED_H
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+enum diskScheduleAlg {_FCFS = 1, _SSTF, _SCAN, _CSCAN,      // 磁盘调度算法标签
+                      _LOOK, _CLOOK, _NSCAN, _FSCAN, _SPTF,
+                      _DEADLINE, _BFQ};
+
+struct dTimedTask {                                         // 在线模式寻道任务
+    uint64_t track;                                         // 目标磁道
+    int sector;                                             // 目标扇区
+    int sectors;                                            // 传输扇区数，0 表示使用设备模型的默认值
+    int owner;                                              // 所属逻辑请求（磁盘阵列模式）
+    int rmw;                                                // 所属读-改-写组（磁盘阵列模式），-1 表示无
+    int pid;                                                // 发出请求的进程
+    bool write;                                             // 是否为写请求
+    double arrival;                                         // 到达时刻(ms)
+    double start;                                           // 开始调度时刻(ms)
+    double finish;                                          // 完成时刻(ms)
+};
+/*
+ * 磁盘设备模型:
+ *  服务时间 = 寻道时间 + 旋转延迟 + 传输时间。寻道时间曲线可替换：
+ *      linearSeek: settle + perTrack * d；
+ *      curveSeek:  短距离 settle + sqrtCoef * sqrt(d)（加速阶段），超过 boundary 后按 perTrack 线性增长。
+ *  rpm > 0 时按转速计算盘片角度：扇区 s 位于 s / sectorsPerTrack 圈处，寻道结束后等待目标扇区
+ *  转到磁头下，再传输 transferSectors 个扇区；rpm 为 0 时只计寻道时间。
+ */
+struct diskModel;
+typedef double (*pSeekFunc)(const diskModel* model, long long distance);
+struct diskModel {
+    pSeekFunc seek;                                         // 寻道时间曲线
+    double settle;                                          // 稳定时间(ms)
+    double perTrack;                                        // 每磁道移动时间(ms)
+    double sqrtCoef;                                        // 短距离寻道 sqrt 系数(ms)
+    int boundary;                                           // 短/长距离寻道分界(磁道)
+    double rpm;                                             // 转速，0 表示不计旋转延迟和传输时间
+    int sectorsPerTrack;                                    // 每磁道扇区数
+    int transferSectors;                                    // 每个请求传输的扇区数
+};
+struct onlineConfig {                                       // 在线模式参数
+    int algNum;                                             // 磁盘调度算法
+    uint64_t position;                                      // 初始磁头位置
+    int direction;                                          // 初始磁臂移动方向
+    uint64_t diskSize;                                      // 磁盘柱面数，0 表示未指定
+    int stepSize;                                           // N 步扫描法每组请求数
+    double readExpire;                                      // 截止时间调度读请求期限(ms)
+    double writeExpire;                                     // 截止时间调度写请求期限(ms)
+    uint64_t budget;                                        // 公平排队每次选中进程的预算(扇区)
+    diskModel model;                                        // 磁盘设备模型
+    const uint64_t* tracks;                                 // 按编号索引的目标磁道（内部使用）
+    const int* sectors;                                     // 按编号索引的目标扇区（内部使用）
+    const dTimedTask* reqs;                                 // 按编号索引的请求（内部使用）
+};
+struct onlineResult {                                       // 在线模式结果
+    std::vector<uint64_t> order;                            // 服务顺序
+    uint64_t totalTracks;                                   // 总寻道数
+    double makespan;                                        // 全部完成时刻(ms)
+    std::vector<long long> depthHist;                       // 队列深度分布：每次调度时的队列长度计数
+};
+/*
+ * 磁盘阵列模式:
+ *  逻辑块按条带单元(stripe 个块)依次分布到 disks 块磁盘上，块号即扇区号，
+ *  物理块 pb 位于磁道 pb / sectorsPerTrack、扇区 pb % sectorsPerTrack。
+ *      RAID-0: 条带 k 位于磁盘 k % disks；
+ *      RAID-1: 每块磁盘都是完整镜像，逻辑块 b 即各盘物理块 b，不按条带拆分：整个逻辑请求作为
+ *              一个物理请求，读请求按逻辑请求编号轮流分配，写请求写所有磁盘；
+ *      RAID-5: 每行 disks - 1 个数据条带和 1 个校验条带，校验盘逐行轮换。写请求逐行处理：
+ *              覆盖整行时直接写数据和新校验；否则每行做一次读-改-写，读出涉及的旧数据和
+ *              旧校验（范围为各数据条带单元内偏移的并集），再写新数据和新校验。
+ *  一个逻辑请求拆成若干物理请求，每块磁盘在各自的线程中独立运行调度算法。同一行的读和写
+ *  组成一个读-改-写组（rmw），组内的写在组内所有读完成时才到达：先调度其余请求得到读的
+ *  完成时刻，再把写在该时刻释放后整体重新调度；写会推迟同一磁盘上的读，读的完成时刻晚于
+ *  释放时刻时推迟释放并重复，直到每个写都在其读完成之后到达。逻辑请求在其最后一个物理
+ *  请求完成时完成。
+ */
+struct raidLayout {                                         // 磁盘阵列参数
+    int level;                                              // RAID 级别：0、1、5
+    int disks;                                              // 磁盘数
+    int stripe;                                             // 条带单元大小(块)
+};
+struct raidRequest {                                        // 逻辑请求
+    long long lba;                                          // 起始逻辑块
+    int blocks;                                             // 块数
+    double arrival;                                         // 到达时刻(ms)
+    bool write;                                             // 是否为写请求
+    double finish;                                          // 完成时刻(ms)
+};
+/*
+ * 块设备访问记录导入（blkparse 默认文本格式）:
+ *      设备 CPU 序号 时间(s) 进程号 事件 RWBS 起始扇区 + 扇区数 [进程名]
+ *  逐行读取，只取指定事件（默认 Q，即请求进入块层）的读写请求。扇区按几何参数换算：
+ *  柱面（磁道号）= 扇区 / (每磁道扇区数 * 磁头数)，盘片角度由扇区 % 每磁道扇区数 决定。
+ *  与电梯调度器一样合并相邻请求：新请求与合并窗口内尚未过期的同方向请求首尾相接时，
+ *  接在其后（后向合并）或其前（前向合并），合并后的大小不超过 MAX_MERGE_SECTORS。
+ */
+struct blkImport {                                          // 导入参数
+    const char* path;                                       // 记录文件，"-" 表示标准输入
+    int heads;                                              // 磁头数
+    double mergeWindow;                                     // 合并窗口(ms)，0 表示不合并
+    char action;                                            // 采用的事件类型
+};
+/*
+ * 批处理磁盘调度器:
+ *  所有请求在 0 时刻到达，一次排出服务顺序。请求只保存目标磁道：tasks 为 64 位磁道号数组，
+ *  run() 把服务顺序就地写回 tasks（扫描类算法排序后逐段逆序或轮转），每个请求只占 8 字节。
+ *  SSTF 运行时另需一份去重的磁道副本和每个不同磁道 16 字节的 32 位下标，请求数须小于 2^32。
+ *  状态全部在实例中，多个调度器可以在同一进程中同时运行。
+ */
+class DiskScheduler {
+public:
+    explicit DiskScheduler(FILE* out = stdout);
+    void add(uint64_t track);                               // 添加一个磁道请求
+    bool run(int algNum, uint64_t position, int direction); // 执行算法，不支持批处理的算法返回 false
+    void output();                                          // 输出结果函数
+
+    std::vector<uint64_t> tasks;                            // 任务队列，run() 后为服务顺序
+    size_t taskNum;                                         // 任务总数
+    uint64_t totalTracks;                                   // 总寻道数
+    size_t sTag;                                            // 已排定服务顺序的请求数
+    uint64_t position;                                      // 初始磁头位置
+    uint64_t headPos;                                       // 当前磁头位置
+    uint64_t diskSize;                                      // 磁盘柱面数，0 表示未指定
+    int stepSize;                                           // N 步扫描法每组请求数
+
+private:
+    void FCFS();                                            // 先来先服务
+    void SSTF();                                            // 最短寻道时间优先
+    void SCAN(int mvDirection);                             // 扫描法
+    void CSCAN(int mvDirection);                            // 循环扫描法
+    void LOOK(int mvDirection);                             // LOOK
+    void CLOOK(int mvDirection);                            // C-LOOK
+    void NSCAN(int mvDirection);                            // N 步扫描法
+    void FSCAN(int mvDirection);                            // 双队列扫描法
+    int sweep(size_t first, size_t last, int mvDirection, bool circular, bool toEdge);
+    void serve(size_t i);                                   // 服务一个请求
+    void moveTo(uint64_t track);                            // 磁头移动
+
+    FILE* out;                                              // 输出流
+};
+
+/*
+ * 按时间模拟的在线调度引擎:
+ *  onlineSchedule 按到达时刻模拟 reqs，填写每个请求的 start/finish 并返回服务顺序和寻道数；
+ *  所有状态都在局部变量中，可在多个线程中同时运行。
+ */
+double linearSeek(const diskModel* model, long long distance);
+double curveSeek(const diskModel* model, long long distance);
+double rotationalWait(const diskModel* model, double clock, int sector);
+double transferTime(const diskModel* model, int sectors);
+void onlineSchedule(std::vector<dTimedTask>& reqs, const onlineConfig* cfg, onlineResult* res);
+void onlineOutput(const std::vector<dTimedTask>& reqs, const onlineConfig* cfg, const onlineResult* res, FILE* out);
+double percentile(const std::vector<double>& values, double p);
+int raidMap(const raidLayout* layout, const diskModel* model, const std::vector<raidRequest>& reqs,
+            std::vector<std::vector<dTimedTask> >& perDisk);
+
+#endif
@@ -3,80 +3,67 @@
 #include <algorithm>
 #include <cstdio>
 #include <queue>
+#include "OSSim.h"
 
 using namespace std;
 
-/*
- * Process Control Block Table:
- * 1. Singleton: 
- *      This should be a singleton structure, which is also a global variable that may be accessed by other processes.
- * 2. Signal Handler: (TODO)
- *      Another thing to note is that maybe I should implement a signal handler to make scheduling easier.
- */
-struct task_struct {
-    int pid;                // Process ID: [0, 65535]
-    int status;             // Status(Maybe enum value)
-
-    int t_arr;              // Arrival Time
-    int t_run_init;         // Initial Burst Time:          t_run_init      = t_run_exec + t_run_rest
-    int t_run_exec;         // Executed Burst Time:         t_run_exec      = t_stop - t_start
-    int t_run_rest;         // Rest Burst Time:             t_run_rest      = t_run_init - t_run_exec
-    int t_exec_start;       // Execution Start Time:        t_exec_start    = time_now()
-    int t_exec_stop;        // Execution Stop Time:         t_exec_stop     = time_now()
-
-    int order;              // Execution Order
-    int priority;           // Execution Priority
-    int slot;               // Slot
-    bool finished;          // Finished Tag
-    bool in_queue;          // Flag
-} pcb_table[1024];          // Process Control Block Table(Maybe from 0 to 65535)
-int pcb_cnt = 0;            // PCB Counter
-
-/*
- * Scheduling Algorithms:
- * 1. FCFS:
- * 2. SJF:
- * 3. SRTF:
- * 4. RR:
- * 5. DPSA:
- */
-void FCFS();
-void SJF();
-void SRTF();
-void RR();
-void DPSA();
-
-int main() {
+int procSchedMain(int argc, char* argv[]) {
     // 0. Initialize
     int algNum = 0;
+    task_struct task = {};
+    ProcScheduler sched;
     // 1. Get the number of scheduling algorithms
     scanf("%d", &algNum);
     // 2. Read parameters from the command line
-    while (~scanf("%d/%d/%d/%d/%d", &pcb_table[pcb_cnt].pid, &pcb_table[pcb_cnt].t_arr, &pcb_table[pcb_cnt].t_run_init, &pcb_table[pcb_cnt].priority, &pcb_table[pcb_cnt].slot)) {
-        pcb_table[pcb_cnt].t_run_exec = 0;
-        pcb_table[pcb_cnt].t_run_rest = pcb_table[pcb_cnt].t_run_init;
-        pcb_table[pcb_cnt].t_exec_start = 0;
-        pcb_table[pcb_cnt].t_exec_stop = 0;
-        pcb_table[pcb_cnt].order = 0;
-        pcb_table[pcb_cnt].finished = false;
-        pcb_cnt++;
+    while (~scanf("%d/%d/%d/%d/%d", &task.pid, &task.t_arr, &task.t_run_init, &task.priority, &task.slot)) {
+        sched.add(task.pid, task.t_arr, task.t_run_init, task.priority, task.slot);
+        task = task_struct();
     }
     // 3. Call the algorithm
+    sched.run(algNum);
+    return 0;
+}
+
+ProcScheduler::ProcScheduler(FILE* out) : pcb_cnt(0), out(out) {}
+
+void ProcScheduler::add(int pid, int t_arr, int t_run_init, int priority, int slot) {
+    task_struct task = {};
+    task.pid = pid;
+    task.t_arr = t_arr;
+    task.t_run_init = t_run_init;
+    task.priority = priority;
+    task.slot = slot;
+    task.t_run_exec = 0;
+    task.t_run_rest = t_run_init;
+    task.t_exec_start = 0;
+    task.t_exec_stop = 0;
+    task.order = 0;
+    task.finished = false;
+    pcb_table.push_back(task);
+    pcb_cnt++;
+}
+
+bool ProcScheduler::run(int algNum) {
     switch (algNum) {
         case 1: FCFS(); break;
         case 2: SJF(); break;
         case 3: SRTF(); break;
         case 4: RR(); break;
         case 5: DPSA(); break;
+        default: return false;
     }
-    return 0;
+    return true;
+}
+
+void ProcScheduler::report(const task_struct& task) {
+    fprintf(out, "%d/%d/%d/%d/%d\n", task.order, task.pid, task.t_exec_start, task.t_exec_stop, task.priority);
 }
 
-void FCFS() {
+void ProcScheduler::FCFS() {
     // 0. Initialize
     int clock = 0;  // Clock to Record Time
     // 1. Sort the PCB Table
-    sort(pcb_table, pcb_table + pcb_cnt, [](task_struct a, task_struct b) {
+    sort(pcb_table.begin(), pcb_table.begin() + pcb_cnt, [](task_struct a, task_struct b) {
         if (a.t_arr != b.t_arr) return a.t_arr < b.t_arr;
         else return a.pid < b.pid;
     });
@@ -94,11 +81,11 @@ void FCFS() {
         pcb_table[i].order = i + 1;
         pcb_table[i].finished = true;
         // (4) Output the results
-        printf("%d/%d/%d/%d/%d\n", pcb_table[i].order, pcb_table[i].pid, pcb_table[i].t_exec_start, pcb_table[i].t_exec_stop, pcb_table[i].priority);
+        report(pcb_table[i]);
     }
 }
 
-void SJF() {
+void ProcScheduler::SJF() {
     // 0. Initialize
     int clock = 0;                      // Clock to Record Time
     int curr_tag = 0;                   // Current Process Subscript
@@ -108,7 +95,7 @@ void SJF() {
         pcb_table[i].t_run_rest = pcb_table[i].t_run_init - pcb_table[i].t_run_exec;
     }
     // 1. Sort the PCB Table
-    sort(pcb_table, pcb_table + pcb_cnt, [](task_struct a, task_struct b) {
+    sort(pcb_table.begin(), pcb_table.begin() + pcb_cnt, [](task_struct a, task_struct b) {
         if (a.t_arr != b.t_arr) return a.t_arr < b.t_arr;
         else if (a.t_run_init != b.t_run_init) return a.t_run_init < b.t_run_init;
         else return a.pid < b.pid;
@@ -139,11 +126,11 @@ void SJF() {
         pcb_table[curr_tag].order = finished_proc_cnt;
         pcb_table[curr_tag].finished = true;
         // (6) Output the results
-        printf("%d/%d/%d/%d/%d\n", pcb_table[curr_tag].order, pcb_table[curr_tag].pid, pcb_table[curr_tag].t_exec_start, pcb_table[curr_tag].t_exec_stop, pcb_table[curr_tag].priority);
+        report(pcb_table[curr_tag]);
     }
 }
 
-void SRTF() {
+void ProcScheduler::SRTF() {
     // 0. Initialize
     int clock = 0;                      // Clock to Record Time
     int order = 1;                      // Order
@@ -155,7 +142,7 @@ void SRTF() {
         pcb_table[i].t_run_rest = pcb_table[i].t_run_init;
     }
     // 1. Sort the PCB Table
-    sort(pcb_table, pcb_table + pcb_cnt, [](task_struct a, task_struct b) {
+    sort(pcb_table.begin(), pcb_table.begin() + pcb_cnt, [](task_struct a, task_struct b) {
         if (a.t_arr != b.t_arr) return a.t_arr < b.t_arr;
         else if (a.t_run_init != b.t_run_init) return a.t_run_init < b.t_run_init;
         else return a.pid < b.pid;
@@ -179,13 +166,13 @@ void SRTF() {
             pcb_table[prev_tag].t_exec_stop = clock - 1;
             pcb_table[prev_tag].order = order++;
             // output
-            printf("%d/%d/%d/%d/%d\n", pcb_table[prev_tag].order, pcb_table[prev_tag].pid, pcb_table[prev_tag].t_exec_start, pcb_table[prev_tag].t_exec_stop, pcb_table[prev_tag].priority);
+            report(pcb_table[prev_tag]);
         }
         if (pcb_table[curr_tag].t_run_rest <= 0) {
             pcb_table[curr_tag].finished = true;
             pcb_table[curr_tag].t_exec_stop = clock;
             pcb_table[curr_tag].order = order++;
-            printf("%d/%d/%d/%d/%d\n", pcb_table[curr_tag].order, pcb_table[curr_tag].pid, pcb_table[curr_tag].t_exec_start, pcb_table[curr_tag].t_exec_stop, pcb_table[curr_tag].priority);
+            report(pcb_table[curr_tag]);
         }
         prev_tag = curr_tag;
         if (pcb_table[curr_tag].finished) {
@@ -196,7 +183,7 @@ void SRTF() {
     }
 }
 
-void RR() {
+void ProcScheduler::RR() {
     // 0. Initialize
     int clock = 0;
     int order = 1;
@@ -205,8 +192,9 @@ void RR() {
     int all_finished = 0;
     task_struct tmp_task;
     queue<task_struct> qready;
+    if (pcb_cnt == 0) return;
     // 1. Sort the PCB Table
-    sort(pcb_table, pcb_table + pcb_cnt, [](task_struct a, task_struct b) {
+    sort(pcb_table.begin(), pcb_table.begin() + pcb_cnt, [](task_struct a, task_struct b) {
         if (a.t_arr != b.t_arr) return a.t_arr < b.t_arr;
         else return a.pid < b.pid;
     });
@@ -229,7 +217,7 @@ void RR() {
         tmp_task.t_exec_start = clock;
         tmp_task.t_exec_stop = tmp_task.t_exec_start + t_temp;
         tmp_task.t_run_rest -= t_temp;
-        printf("%d/%d/%d/%d/%d\n", tmp_task.order, tmp_task.pid, tmp_task.t_exec_start, tmp_task.t_exec_stop, tmp_task.priority);
+        report(tmp_task);
 
         clock = tmp_task.t_exec_stop;
 
@@ -247,7 +235,7 @@ void RR() {
     }
 }
 
-void DPSA() {
+void ProcScheduler::DPSA() {
     // 0. Set variables
     int clock = 0;                              // Clock to record current time
     int curr_tag = 0;                           // Subscription for current process
@@ -261,7 +249,7 @@ void DPSA() {
         pcb_table[i].t_run_rest = pcb_table[i].t_run_init;
     }
     // 2. Sort the PCB Table
-    sort(pcb_table, pcb_table + pcb_cnt, [](task_struct a, task_struct b) {
+    sort(pcb_table.begin(), pcb_table.begin() + pcb_cnt, [](task_struct a, task_struct b) {
         if (a.t_arr != b.t_arr) return a.t_arr < b.t_arr;
         else return a.pid < b.pid;
     });
@@ -338,7 +326,7 @@ void DPSA() {
             all_finished++;
         }
         // 2.4  Output the result
-        printf("%d/%d/%d/%d/%d\n", pcb_table[curr_tag].order, pcb_table[curr_tag].pid, pcb_table[curr_tag].t_exec_start, pcb_table[curr_tag].t_exec_stop, pcb_table[curr_tag].priority);
+        report(pcb_table[curr_tag]);
 
         // 2.5  Update the ready queue
         for (int i = 0;  i < pcb_cnt; i++) {
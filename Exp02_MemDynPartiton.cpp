@@ -1,60 +1,44 @@
 /* Memory Dynamic Partition */
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
+#include "OSSim.h"
 #define MAX_MEM_SIZE 65535
 
 using namespace std;
 
-// MState 内存块的状态
-enum MState {UNUSED, USED};
-// Memory 内存块结构体
-struct Memory {
-    int startAddr;          // 起始地址
-    int endAddr;            // 结束地址
-    int size;               // 内存块大小
-    int pid;                // 进程ID
-    MState state;           // 内存块状态
-    struct Memory *next;    // 下一个内存块
-};
-// ReqList 请求列表
-struct Request {
-    int sn;         // serial number
-    int pid;        // process id
-    int op;         // operation
-    int opVol;      // volume of operation
-} rList[1024];
-// pFunc 函数指针：用于不同的内存分配算法
-typedef void (*pFunc)(Request request, Memory *mem);
-// FF 分配函数
-void FFalloc(Request request, Memory *mem);
-// BF 分配函数
-void BFalloc(Request request, Memory *mem);
-// WF 分配函数
-void WFalloc(Request request, Memory *mem);
-// 内存释放函数
-void memFree(Request request, Memory *mem);
-// 结果输出函数
-void output(Request request, Memory *mem);
-
-int main()
+int memPartitionMain(int argc, char *argv[])
 {
     int algNum = 0;             // number of algorithms
     int memSize = 0;            // size of memory
-    int num = 0;                // number of current request
-    pFunc pAlloc;               // function to allocate
-    Memory *memory;             // memory
+    Request request = {};       // current request
+    vector<Request> rList;      // request list
     // 1. 读取算法和内存大小
     scanf("%d %d", &algNum, &memSize);
     // 2. 读取请求序列
-    while (~scanf("%d/%d/%d/%d", &rList[num].sn, &rList[num].pid, &rList[num].op, &rList[num].opVol)) { num++; }
-    // Test Start: Input
-//    int tmp = 17;
-//    for (int i = 0; i < tmp; i++) {
-//        scanf("%d/%d/%d/%d", &rList[i].sn, &rList[i].pid, &rList[i].op, &rList[i].opVol);
-//    }
-//    num = tmp;
-    // Test End
+    while (~scanf("%d/%d/%d/%d", &request.sn, &request.pid, &request.op, &request.opVol)) {
+        rList.push_back(request);
+        request = Request();
+    }
     // 3. 初始化内存
+    PartitionAllocator allocator(memSize);
+    // 4. 算法选择
+    if (!allocator.select(algNum)) {
+        printf("Unknown algorithm");
+        exit(EXIT_FAILURE);
+    }
+    // 5. 执行算法
+    for (size_t i = 0; i < rList.size(); i++) {
+        if (!allocator.apply(rList[i])) {
+            printf("Error: Invalid operation number %d", (int)i);
+            exit(EXIT_FAILURE);
+        }
+        allocator.output(rList[i]);
+    }
+    return 0;
+}
+PartitionAllocator::PartitionAllocator(int memSize, FILE *out) : pAlloc(nullptr), out(out)
+{
     memory = (Memory*)malloc(sizeof(Memory));
     memory->startAddr = 0;
     memory->endAddr = memSize - 1;
@@ -62,29 +46,37 @@ int main()
     memory->pid = -1;
     memory->state = UNUSED;
     memory->next = nullptr;
-    // 4. 算法选择
+}
+PartitionAllocator::~PartitionAllocator()
+{
+    while (memory != nullptr) {
+        Memory *next = memory->next;
+        free(memory);
+        memory = next;
+    }
+}
+// 算法选择
+bool PartitionAllocator::select(int algNum)
+{
     switch (algNum) {
         case 1: pAlloc = FFalloc; break;
         case 2: pAlloc = BFalloc; break;
         case 3: pAlloc = WFalloc; break;
-        default: {
-            printf("Unknown algorithm");
-            exit(EXIT_FAILURE);
-        }
+        default: return false;
     }
-    // 5. 执行算法
-    for (int i = 0; i < num; i++) {
-        if (rList[i].op == 1) {
-            pAlloc(rList[i], memory);
-        } else if (rList[i].op == 2) {
-            memFree(rList[i], memory);
-        } else {
-            printf("Error: Invalid operation number %d", i);
-            exit(EXIT_FAILURE);
-        }
-        output(rList[i], memory);
+    return true;
+}
+// 执行请求：1 分配，2 释放
+bool PartitionAllocator::apply(Request request)
+{
+    if (request.op == 1) {
+        pAlloc(request, memory);
+    } else if (request.op == 2) {
+        memFree(request, memory);
+    } else {
+        return false;
     }
-    return 0;
+    return true;
 }
 // FF 分配函数
 void FFalloc(Request request, Memory *mem)
@@ -247,16 +239,17 @@ void memFree(Request request, Memory *mem)
     }
 }
 // 结果输出函数
-void output(Request request, Memory *mem)
+void PartitionAllocator::output(Request request)
 {
-    printf("%d", request.sn);
+    Memory *mem = memory;
+    fprintf(out, "%d", request.sn);
     while (mem != nullptr) {
         if (mem->state == USED) {
-            printf("/%d-%d.1.%d", mem->startAddr, mem->endAddr, mem->pid);
+            fprintf(out, "/%d-%d.1.%d", mem->startAddr, mem->endAddr, mem->pid);
         } else if (mem->state == UNUSED) {
-            printf("/%d-%d.0", mem->startAddr, mem->endAddr);
+            fprintf(out, "/%d-%d.0", mem->startAddr, mem->endAddr);
         }
         mem = mem->next;
     }
-    printf("\n");
+    fprintf(out, "\n");
 }
\ No newline at end of file
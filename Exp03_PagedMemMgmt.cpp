@@ -1,217 +1,866 @@
 /* Paged Memory Management */
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <sys/mman.h>
+#include "OSSim.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
-#define MAX_SIZE 1024
+#define DEFAULT_WINDOW (1 << 20)                // OPT 默认前瞻窗口（访问数）
+#define FAR_POSITION LONG_MAX                   // 不再访问（或在前瞻窗口外）的页面的下次访问位置
+#define TRACE_CHUNK (1 << 20)                   // 建立二进制序列索引时每块解码的访问数
+#define DEFAULT_STATS_WINDOW 1000               // 缺页率时间线默认采样窗口（访问数）
+#define DEFAULT_TOP_K 10                        // 默认统计的热点页面数
+#define SIMD_LANES 8                            // 页号数组最小补齐宽度（一个 AVX2 向量）
+#define SIMD_ALIGN 32                           // 页号数组对齐字节数
+#define SMALL_FRAMES 64                         // 小驻留集上限：按编译期大小特化
+#define PAD_PID INT_MIN                         // 补齐位置的页号，不会与任何页面或空闲标记匹配
 
 using namespace std;
 
-enum memMgmtAlg {OPT = 1, FIFO, LRU};           // 页面置换算法标签
-enum pageFlag {MISS = 0, HIT};                  // 页面命中标签
-enum fullFlag {NOT_FULL = 0, FULL};             // 驻留集空闲页标签
-
-struct residentSet {                            // 驻留集
-    int pid;                                    // 进程号
-    int priority;                               // 优先级
-    int distance;                               // 距离
-};
-typedef void (*pUpdateFunc)(residentSet* rSet, int pageNum, int hitPage);
-typedef void (*pReplaceFunc)(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc);
-void pageAdd(residentSet* rSet, int pageNum, int freePage, const int* procSeq, int currProc);
-void updateOPTandFIFO(residentSet* rSet, int pageNum, int hitPage);
-void updateLRU(residentSet* rSet, int pageNum, int hitPage);
-void replaceOPT(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc);
-void replaceFIFO(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc);
-void replaceLRU(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc);
-
-int main()
+int pagedMemMain(int argc, char* argv[])
 {
     // 页面置换算法
     int mmAlgNum;                               // 页面置换算法序号
-    pUpdateFunc pageUpdate;                     // 更新驻留集页面
-    pReplaceFunc pageReplace;                   // 替换驻留集页面
+    PagedMemory mm;                             // 页框表和页面置换策略
+    long optWindow = DEFAULT_WINDOW;            // OPT 前瞻窗口大小(-w)
+    // 批量模式
+    bool batch = false;                         // 是否为批量模式(-B)
+    const char* algList = "1,2,3";              // 算法列表(-a)
+    const char* frameList = "3";                // 驻留集页面数列表(-f)
+    int threads = 0;                            // 线程数(-j)，0 表示按 CPU 核数
+    // 二进制访问序列
+    const char* tracePath = nullptr;            // 二进制访问序列文件(-t)
+    traceReader trace;                          // 二进制访问序列读取器
+    // 缺页统计
+    const char* statsPath = nullptr;            // 统计结果输出文件(-s)，"-" 表示标准错误
+    long statsWindow = DEFAULT_STATS_WINDOW;    // 时间线采样窗口(-W)
+    int topK = DEFAULT_TOP_K;                   // 热点页面数(-K)
+    pageStats* stats = nullptr;                 // 缺页统计
     // 驻留集
     int pagesNum;                               // 驻留集页面数
     // 进程序列
-    int procSeq[MAX_SIZE] = {0};                // 进程序列
-    int procNum = 0;                            // 进程序列总数
+    refStream refs;                             // 进程序列流
+    int currPage;                               // 当前访问页面
+    long procNum = 0;                           // 已模拟的进程序列数
     // 缺页中断
     pageFlag hitFlag;                           // 命中标志
-    int hitPage;                                // 命中页号
-    fullFlag isFull;                            // 空闲标志
-    int freePage;                               // 空闲页号
-    int missTimes = 0;                          // 缺页次数
+    // 0. 读取命令行参数
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            optWindow = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-B") == 0) {
+            batch = true;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            algList = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            frameList = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) {
+            statsWindow = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-K") == 0 && i + 1 < argc) {
+            topK = atoi(argv[++i]);
+        } else {
+            printf("Usage: %s [-t trace.bin] [-w window] [-s stats.json [-W window] [-K topK]]"
+                   " | -B [-a algs] [-f frames] [-j threads]", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (tracePath != nullptr && !traceOpen(&trace, tracePath, TRACE_PAGES)) {
+        printf("Invalid trace file.");
+        exit(EXIT_FAILURE);
+    }
+    if (batch) {
+        bool done = runBatch(stdout, algList, frameList, threads, tracePath != nullptr ? &trace : nullptr);
+        if (tracePath != nullptr) traceClose(&trace);
+        if (!done) exit(EXIT_FAILURE);
+        return 0;
+    }
     // 1. 读入页面置换算法序号和驻留集页面数
-    scanf("%d %d", &mmAlgNum, &pagesNum);
+    if (scanf("%d %d", &mmAlgNum, &pagesNum) != 2 || pagesNum < 1) {
+        printf("Invalid number of pages.");
+        exit(EXIT_FAILURE);
+    }
     // 2. 初始化驻留集和页面置换算法
-    residentSet rSet[pagesNum];
-    for (int i = 0; i < pagesNum; i++) {
-        rSet[i].pid = -1;
-        rSet[i].priority = -1;
-        rSet[i].distance = MAX_SIZE;
+    if (!selectPolicy(mmAlgNum, &mm.policy)) {
+        printf("Unrecognized Algorithm.");
+        exit(EXIT_FAILURE);
+    }
+    if (!mm.init(mmAlgNum, pagesNum)) {
+        printf("Out of memory.");
+        exit(EXIT_FAILURE);
+    }
+    if (statsPath != nullptr) {
+        stats = new pageStats;
+        statsInit(stats, pagesNum, statsWindow > 0 ? statsWindow : DEFAULT_STATS_WINDOW, topK > 0 ? topK : DEFAULT_TOP_K);
+    }
+    // 3. 打开进程序列流
+    if (!refInit(&refs, stdin, tracePath != nullptr ? &trace : nullptr, mm.policy.lookahead ? max(optWindow, 1L) : 0)) {
+        printf("Out of memory.");
+        exit(EXIT_FAILURE);
     }
+    // 4. 模拟执行：边读边模拟
+    while (refNext(&refs, &currPage)) {
+        hitFlag = mm.access(currPage, &refs);
+        if (stats != nullptr) statsRecord(stats, currPage, hitFlag, mm.ft->victim);
+        // 4.1 输出分隔符（序列长度未知，在每一步之前输出）
+        if (procNum++ > 0) printf("/");
+        // 4.2 输出当前驻留集中进程序列
+        for (int k = 0; k < pagesNum; k++) {
+            if (mm.ft->pids[k] != -1) printf("%d,", mm.ft->pids[k]);
+            else printf("-,");
+        }
+        // 4.3 输出是否命中
+        printf("%d", hitFlag);
+    }
+    if (refs.invalid) {
+        printf("Invalid page number.");
+        exit(EXIT_FAILURE);
+    }
+    if (tracePath != nullptr && trace.remaining != 0) {
+        printf("Truncated trace file.");
+        exit(EXIT_FAILURE);
+    }
+    // 4.4 输出结束符和缺页次数
+    if (procNum > 0) printf("\n");
+    printf("%ld\n", mm.missTimes);
+    // 5. 输出缺页统计
+    if (stats != nullptr) {
+        FILE* out = strcmp(statsPath, "-") == 0 ? stderr : fopen(statsPath, "w");
+        if (out == nullptr) {
+            printf("Cannot open %s\n", statsPath);
+            exit(EXIT_FAILURE);
+        }
+        statsWrite(stats, out, mmAlgNum, pagesNum);
+        if (out != stderr) fclose(out);
+        delete stats;
+    }
+    refFree(&refs);
+    if (tracePath != nullptr) traceClose(&trace);
+    return 0;
+}
+
+bool selectPolicy(int mmAlgNum, pagePolicy* policy)
+{
+    policy->lookahead = false;
     switch (mmAlgNum) {
         case OPT: {
-            pageUpdate = updateOPTandFIFO;
-            pageReplace = replaceOPT;
+            policy->update = nullptr;
+            policy->replace = replaceOPT;
+            policy->lookahead = true;
             break;
         }
         case FIFO: {
-            pageUpdate = updateOPTandFIFO;
-            pageReplace = replaceFIFO;
+            policy->update = nullptr;
+            policy->replace = replaceFIFO;
             break;
         }
         case LRU: {
-            pageUpdate = updateLRU;
-            pageReplace = replaceLRU;
+            policy->update = updateLRU;
+            policy->replace = replaceLRU;
             break;
         }
-        default: {
-            printf("Unrecognized Algorithm.");
-            exit(EXIT_FAILURE);
+        case CLOCK: {
+            policy->update = updateCLOCK;
+            policy->replace = replaceCLOCK;
+            break;
         }
+        default: return false;
     }
-    // 3. 读入进程序列
-    char tmpChar;
-    while (scanf("%d", &procSeq[procNum])) {
-        procNum++;
-        tmpChar = getchar();
-        if (tmpChar == ',') continue;
-        else if (tmpChar == '\n') break;
-    }
-    // 4. 模拟执行
-    for (int i = 0; i < procNum; i++) {
-        // 1. 检查是否有空闲页面
-        isFull = FULL;
-        freePage = -1;
-        for (int j = 0; j < pagesNum; j++) {
-            if (rSet[j].pid == -1) {
-                isFull = NOT_FULL;              // 说明驻留集中还有空闲页面
-                freePage = j;                   // 记录驻留集中空闲页下标
-                break;
-            }
+    return true;
+}
+template <int N> int findFrame(const int* pids, int pid);
+int findFrameLarge(const int* pids, int capacity, int pid);
+// 模拟一次页面访问，返回是否命中；N 为页号数组补齐后的长度，0 表示大驻留集
+template <int N>
+static pageFlag accessFrames(frameTable* ft, const pagePolicy* policy, int currPage, refStream* refs)
+{
+    pageFlag hitFlag;                           // 命中标志
+    int hitPage;                                // 命中页号
+    int freePage;                               // 空闲页号
+    ft->victim = -1;
+    // 1. 检查是否命中
+    //    只接受驻留集内的匹配：补齐位置（PAD_PID）不是页框
+    hitPage = N > 0 ? findFrame<N>(ft->pids, currPage) : findFrameLarge(ft->pids, ft->capacity, currPage);
+    hitFlag = hitPage >= 0 && hitPage < ft->pagesNum ? HIT : MISS;
+    // 2. 将页面加载到驻留集中
+    //    已命中——>重置该进程参数并进入下一个进程(continue)
+    //    未命中——>缺页中断，检查是否有空闲页面
+    //            驻留集未满：加载到驻留集中空闲页中
+    //            驻留集已满：先采用页面置换策略得到空闲页，再加载该进程
+    if (hitFlag) {                              // 命中驻留集中的页面：更新参数
+        if (policy->update != nullptr) policy->update(ft, hitPage);
+        if (policy->lookahead) ft->frames[hitPage].lastUse = refs->pos - 1;
+        return hitFlag;
+    }
+    freePage = ft->used < ft->pagesNum ? ft->used : -1;
+    if (freePage < 0) {                         // 驻留集已满：页面置换
+        policy->replace(ft, currPage, refs);
+    } else {                   // 驻留集未满：将进程页面添加到驻留集中
+        pageAdd(ft, freePage, currPage);
+        if (policy->lookahead) ft->frames[freePage].lastUse = refs->pos - 1;
+    }
+    return hitFlag;
+}
+pageFlag accessPage(frameTable* ft, const pagePolicy* policy, int currPage, refStream* refs)
+{
+    switch (ft->capacity) {
+        case 8: return accessFrames<8>(ft, policy, currPage, refs);
+        case 16: return accessFrames<16>(ft, policy, currPage, refs);
+        case 32: return accessFrames<32>(ft, policy, currPage, refs);
+        case 64: return accessFrames<64>(ft, policy, currPage, refs);
+        default: return accessFrames<0>(ft, policy, currPage, refs);
+    }
+}
+PagedMemory::PagedMemory() : ft(nullptr), missTimes(0) {}
+PagedMemory::~PagedMemory()
+{
+    if (ft != nullptr) frameFree(ft);
+}
+bool PagedMemory::init(int mmAlgNum, int pagesNum)
+{
+    if (pagesNum < 1 || !selectPolicy(mmAlgNum, &policy)) return false;
+    if (ft != nullptr) frameFree(ft);
+    ft = frameAlloc(pagesNum);
+    missTimes = 0;
+    return ft != nullptr;
+}
+pageFlag PagedMemory::access(int currPage, refStream* refs)
+{
+    pageFlag hitFlag = accessPage(ft, &policy, currPage, refs);
+    if (!hitFlag) missTimes++;
+    return hitFlag;
+}
+// 解析 "1,2,3" 或 "4-64" 形式的整数列表
+static bool parseList(const char* text, vector<int>* values)
+{
+    while (*text) {
+        char* end;
+        long lo = strtol(text, &end, 10);
+        long hi = lo;
+        if (end == text) return false;
+        if (*end == '-') {
+            text = end + 1;
+            hi = strtol(text, &end, 10);
+            if (end == text || hi < lo) return false;
         }
-        // 2. 检查是否命中
-        hitFlag = MISS;
-        hitPage = -1;
-        for (int j = 0; j < pagesNum; j++) {
-            if (rSet[j].pid == procSeq[i]) {
-                hitFlag = HIT;                  // 说明驻留集中存在命中的页面
-                hitPage = j;                    // 记录命中页驻留集下标
-                break;
-            }
+        for (long v = lo; v <= hi; v++) values->push_back((int)v);
+        if (*end == ',') end++;
+        else if (*end != '\0') return false;
+        text = end;
+    }
+    return true;
+}
+static const char* algName(int mmAlgNum)
+{
+    switch (mmAlgNum) {
+        case OPT: return "OPT";
+        case FIFO: return "FIFO";
+        case LRU: return "LRU";
+        case CLOCK: return "CLOCK";
+        default: return "?";
+    }
+}
+/*
+ * 批量模式:
+ *  访问序列只解析一次，保存为只读数组并由所有线程共享；算法 × 驻留集页面数的每个
+ *  组合是一个任务，工作线程从共享计数器领取任务，各自使用独立的页框表。
+ *  向 out 输出 CSV：算法,页面数,访问数,缺页次数,命中率。出错时向 out 输出错误信息并返回 false。
+ */
+bool runBatch(FILE* out, const char* algList, const char* frameList, int threads, traceReader* trace)
+{
+    vector<int> algs, frames, data;
+    vector<batchJob> jobs;
+    vector<thread> workers;
+    atomic<size_t> nextJob(0);
+    atomic<bool> failed(false);
+    pagePolicy policy;
+    refStream refs;
+    int page;
+    // 1. 解析算法和驻留集页面数列表，生成任务
+    if (!parseList(algList, &algs) || !parseList(frameList, &frames)) {
+        fprintf(out, "Invalid algorithm or frame list.");
+        return false;
+    }
+    for (size_t i = 0; i < algs.size(); i++) {
+        if (!selectPolicy(algs[i], &policy)) {
+            fprintf(out, "Unrecognized Algorithm.");
+            return false;
         }
-        // 3. 将页面加载到驻留集中
-        //    已命中——>重置该进程参数并进入下一个进程(continue)
-        //    未命中——>缺页中断
-        //            驻留集未满：加载到驻留集中空闲页中
-        //            驻留集已满：先采用页面置换策略得到空闲页，再加载该进程
-        if (hitFlag) {                          // 命中驻留集中的页面：更新参数
-            pageUpdate(rSet, pagesNum, hitPage);
-        } else {
-            if (isFull) {                       // 驻留集已满：页面置换
-                pageReplace(rSet, pagesNum, procSeq, procNum, i);
-            } else {               // 驻留集未满：将进程页面添加到驻留集中
-                pageAdd(rSet, pagesNum, freePage, procSeq, i);
+        for (size_t j = 0; j < frames.size(); j++) {
+            if (frames[j] < 1) {
+                fprintf(out, "Invalid number of pages.");
+                return false;
             }
-            missTimes++;
+            batchJob job = {algs[i], frames[j], 0};
+            jobs.push_back(job);
         }
-        // 4. 输出
-        // 4.1 输出当前驻留集中进程序列
-        for (int k = 0; k < pagesNum; k++) {
-            if (rSet[k].pid != -1) printf("%d,", rSet[k].pid);
-            else printf("-,");
+    }
+    // 2. 读入访问序列（只解析一次）
+    if (trace != nullptr) data.reserve(trace->count);
+    if (!refInit(&refs, stdin, trace, 0)) {
+        fprintf(out, "Out of memory.");
+        return false;
+    }
+    while (refNext(&refs, &page)) data.push_back(page);
+    refFree(&refs);
+    if (refs.invalid) {
+        fprintf(out, "Invalid page number.");
+        return false;
+    }
+    if (trace != nullptr && trace->remaining != 0) {
+        fprintf(out, "Truncated trace file.");
+        return false;
+    }
+    const int* shared = data.empty() ? nullptr : &data[0];
+    long size = (long)data.size();
+    // OPT 的下次访问索引同样只建立一次，由所有 OPT 任务共享
+    vector<uint32_t> nextDist;
+    for (size_t k = 0; k < jobs.size() && nextDist.empty() && size > 0; k++) {
+        if (jobs[k].alg != OPT) continue;
+        nextDist.resize(size);
+        buildNextUse(shared, size, &nextDist[0]);
+    }
+    // 3. 线程池执行所有任务
+    if (threads <= 0) threads = (int)thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    if ((size_t)threads > jobs.size()) threads = (int)jobs.size();
+    auto worker = [&]() {
+        size_t k;
+        while ((k = nextJob.fetch_add(1)) < jobs.size()) {
+            PagedMemory jobMem;
+            refStream jobRefs;
+            int currPage;
+            if (!jobMem.init(jobs[k].alg, jobs[k].pagesNum)) {
+                failed = true;
+                continue;
+            }
+            refInitMem(&jobRefs, shared, size, nextDist.empty() ? nullptr : &nextDist[0]);
+            while (refNext(&jobRefs, &currPage)) jobMem.access(currPage, &jobRefs);
+            refFree(&jobRefs);
+            jobs[k].missTimes = jobMem.missTimes;
         }
-        // 4.2 输出是否命中
-        printf("%d", hitFlag);
-        // 4.3 输出结束符
-        if (i < procNum - 1) printf("/");
-        else printf("\n");
+    };
+    for (int t = 0; t < threads; t++) workers.push_back(thread(worker));
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+    if (failed) {
+        fprintf(out, "Out of memory.");
+        return false;
     }
-    // 4.4 输出缺页次数
-    printf("%d\n", missTimes);
-    return 0;
+    // 4. 输出 CSV
+    fprintf(out, "alg,frames,refs,faults,hit_ratio\n");
+    for (size_t k = 0; k < jobs.size(); k++) {
+        double hitRatio = size > 0 ? (double)(size - jobs[k].missTimes) / size : 0.0;
+        fprintf(out, "%s,%d,%ld,%ld,%.6f\n", algName(jobs[k].alg), jobs[k].pagesNum, size, jobs[k].missTimes, hitRatio);
+    }
+    return true;
 }
 
-void pageAdd(residentSet* rSet, int pageNum, int freePage, const int* procSeq, int currProc)
+void statsInit(pageStats* stats, int pagesNum, long window, int topK)
 {
-    // 驻留集中已有页优先级均下调一个单位
-    for (int i = 0; i < pageNum; i++)
-        if (rSet[i].pid != -1)
-            rSet[i].priority += 1;
-    rSet[freePage].pid = procSeq[currProc];
-    rSet[freePage].priority = 0;
+    stats->window = window;
+    stats->topK = topK;
+    stats->refs = 0;
+    stats->faults = 0;
+    stats->windowFaults = 0;
+    stats->evictions = 0;
+    stats->ageSum = 0;
+    stats->ageMax = 0;
+    memset(stats->faultsByClass, 0, sizeof(stats->faultsByClass));
+    memset(stats->evictionsByClass, 0, sizeof(stats->evictionsByClass));
+    memset(stats->ageHist, 0, sizeof(stats->ageHist));
+    stats->shadowSize = pagesNum;
 }
-void updateOPTandFIFO(residentSet* rSet, int pageNum, int hitPage)
+void statsRecord(pageStats* stats, int currPage, pageFlag hitFlag, int victim)
 {
-    // 驻留集中已有页优先级调整
-    for (int i = 0; i < pageNum; i++)
-        if (rSet[i].pid != -1)
-            rSet[i].priority += 1;
+    long now = stats->refs++;
+    // 1. 影子 LRU：判断缺页原因并更新
+    auto shadow = stats->shadowPos.find(currPage);
+    bool shadowHit = shadow != stats->shadowPos.end();
+    if (shadowHit) {
+        stats->shadowLru.splice(stats->shadowLru.begin(), stats->shadowLru, shadow->second);
+    } else {
+        if ((int)stats->shadowLru.size() == stats->shadowSize) {
+            stats->shadowPos.erase(stats->shadowLru.back());
+            stats->shadowLru.pop_back();
+        }
+        stats->shadowLru.push_front(currPage);
+        stats->shadowPos[currPage] = stats->shadowLru.begin();
+    }
+    // 2. 缺页与淘汰
+    if (!hitFlag) {
+        faultClass reason = !stats->seen.count(currPage) ? COLD : (shadowHit ? CONFLICT : CAPACITY);
+        stats->faults++;
+        stats->windowFaults++;
+        stats->faultsByClass[reason]++;
+        if (victim != -1) {
+            long age = now - stats->loadTime[victim];
+            int bucket = 0;
+            while (bucket < AGE_BUCKETS - 1 && (2L << bucket) <= age) bucket++;
+            stats->evictions++;
+            stats->evictionsByClass[reason]++;
+            stats->ageSum += age;
+            stats->ageMax = max(stats->ageMax, age);
+            stats->ageHist[bucket]++;
+            stats->loadTime.erase(victim);
+        }
+        stats->loadTime[currPage] = now;
+    }
+    stats->seen.insert(currPage);
+    // 3. 热点页面（Space-Saving）：未跟踪的页面替换计数最小的计数器
+    auto pos = stats->hotPos.find(currPage);
+    if (pos != stats->hotPos.end()) {
+        stats->hot[pos->second].count++;
+    } else if ((int)stats->hot.size() < stats->topK) {
+        hotCounter counter = {currPage, 1, 0};
+        stats->hotPos[currPage] = (int)stats->hot.size();
+        stats->hot.push_back(counter);
+    } else {
+        int minIndex = 0;
+        for (int i = 1; i < (int)stats->hot.size(); i++)
+            if (stats->hot[i].count < stats->hot[minIndex].count)
+                minIndex = i;
+        hotCounter& counter = stats->hot[minIndex];
+        stats->hotPos.erase(counter.page);
+        stats->hotPos[currPage] = minIndex;
+        counter.page = currPage;
+        counter.error = counter.count;
+        counter.count++;
+    }
+    // 4. 时间线
+    if (stats->refs % stats->window == 0) {
+        stats->timeline.push_back(stats->windowFaults);
+        stats->windowFaults = 0;
+    }
 }
-void updateLRU(residentSet* rSet, int pageNum, int hitPage)
+void statsWrite(const pageStats* stats, FILE* out, int mmAlgNum, int pagesNum)
 {
-    int freePages = 0;
-    for (int i = 0; i < pageNum; i++) {
-        if (rSet[i].pid == -1)
-            freePages++;
+    const char* classNames[3] = {"cold", "capacity", "conflict"};
+    vector<hotCounter> hot = stats->hot;
+    int lastBucket = 0;
+    sort(hot.begin(), hot.end(), [] (const hotCounter& a, const hotCounter& b) {
+        return a.count != b.count ? a.count > b.count : a.page < b.page;
+    });
+    for (int i = 0; i < AGE_BUCKETS; i++)
+        if (stats->ageHist[i]) lastBucket = i;
+    fprintf(out, "{\"alg\":\"%s\",\"frames\":%d,\"refs\":%ld,\"faults\":%ld,\"hit_ratio\":%.6f,\n",
+            algName(mmAlgNum), pagesNum, stats->refs, stats->faults,
+            stats->refs > 0 ? (double)(stats->refs - stats->faults) / stats->refs : 0.0);
+    // 最后一个不完整的窗口也输出
+    fprintf(out, " \"window\":%ld,\"timeline\":[", stats->window);
+    for (size_t i = 0; i < stats->timeline.size(); i++)
+        fprintf(out, i ? ",%ld" : "%ld", stats->timeline[i]);
+    if (stats->refs % stats->window != 0)
+        fprintf(out, stats->timeline.empty() ? "%ld" : ",%ld", stats->windowFaults);
+    fprintf(out, "],\n \"faults_by_class\":{");
+    for (int i = 0; i < 3; i++)
+        fprintf(out, "%s\"%s\":%ld", i ? "," : "", classNames[i], stats->faultsByClass[i]);
+    fprintf(out, "},\n \"evictions\":{\"total\":%ld,\"by_class\":{", stats->evictions);
+    for (int i = 0; i < 3; i++)
+        fprintf(out, "%s\"%s\":%ld", i ? "," : "", classNames[i], stats->evictionsByClass[i]);
+    fprintf(out, "},\"age_mean\":%.3f,\"age_max\":%ld,\"age_log2_hist\":[",
+            stats->evictions > 0 ? (double)stats->ageSum / stats->evictions : 0.0, stats->ageMax);
+    for (int i = 0; i <= lastBucket; i++)
+        fprintf(out, i ? ",%ld" : "%ld", stats->ageHist[i]);
+    fprintf(out, "]},\n \"hot_pages\":[");
+    for (size_t i = 0; i < hot.size(); i++)
+        fprintf(out, "%s{\"page\":%d,\"count\":%ld,\"error\":%ld}", i ? "," : "", hot[i].page, hot[i].count, hot[i].error);
+    fprintf(out, "]}\n");
+}
+// 非法页号：结束序列并置 invalid
+static bool badRef(refStream* refs)
+{
+    refs->eof = true;
+    refs->invalid = true;
+    return false;
+}
+// 读取一个访问：二进制序列直接解码；文本格式与 scanf("%d") + getchar() 相同，以 ',' 分隔，以换行结束
+static bool readRef(refStream* refs, int* page)
+{
+    int c;
+    long value = 0;
+    if (refs->eof) return false;
+    if (refs->trace != nullptr) {
+        int64_t tmp;
+        if (!traceNext(refs->trace, &tmp)) {
+            refs->eof = true;
+            return false;
+        }
+        if (tmp < 0 || tmp > INT_MAX) return badRef(refs);
+        *page = (int)tmp;
+        return true;
     }
-    residentSet tmp = rSet[hitPage];
-    for (int i = hitPage; i < pageNum - freePages; i++) {
-        rSet[i] = rSet[i+1];
+    do { c = getc(refs->in); } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    if (c == '-') return badRef(refs);         // 负数页号与空闲页框标记冲突
+    if (c == '+') c = getc(refs->in);
+    if (c < '0' || c > '9') {                   // 不是数字：序列结束
+        refs->eof = true;
+        return false;
+    }
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        if (value > INT_MAX) return badRef(refs);
+        c = getc(refs->in);
     }
-    rSet[pageNum-freePages-1] = tmp;
+    *page = (int)value;
+    if (c == '\n' || c == EOF) refs->eof = true;
+    return true;
 }
-void replaceOPT(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc)
+// 公共初始化：不使用前瞻窗口和下次访问索引
+static bool buildTraceNextUse(refStream* refs);
+static void refReset(refStream* refs)
 {
-    int tmpIndex = 0;                           // 临时下标
-    int maxDistance = 0;                        // 最大距离
-    // 驻留集中已有页优先级调整
-    for (int i = 0; i < pageNum; i++) {
-        if (rSet[i].pid != -1)
-            rSet[i].priority += 1;
-        rSet[i].distance = MAX_SIZE;
-    }
-    // 计算距离
-    for (int i = 0; i < pageNum; i++) {
-        for (int j = currProc; j < procNum; j++) {
-            if (rSet[i].pid == procSeq[j]) {
-                rSet[i].distance = j - currProc;
-                break;
-            }
+    refs->in = nullptr;
+    refs->trace = nullptr;
+    refs->mem = nullptr;
+    refs->memSize = 0;
+    refs->memPos = 0;
+    refs->pos = 0;
+    refs->nextDist = nullptr;
+    refs->ownDist = nullptr;
+    refs->distBytes = 0;
+    refs->window = nullptr;
+    refs->link = nullptr;
+    refs->pending = nullptr;
+    refs->capacity = 0;
+    refs->head = 0;
+    refs->count = 0;
+    refs->eof = true;
+    refs->invalid = false;
+}
+/*
+ * window > 0 时为 OPT 打开前瞻:
+ *  二进制序列在此建立精确的下次访问索引，不需要窗口；标准输入使用 window 个访问的窗口。
+ */
+bool refInit(refStream* refs, FILE* in, traceReader* trace, long window)
+{
+    refReset(refs);
+    refs->in = in;
+    refs->trace = trace;
+    refs->eof = false;
+    refs->capacity = 1;
+    if (trace == nullptr) {
+        while (refs->capacity < window) refs->capacity <<= 1;
+    }
+    refs->window = (int*)malloc(sizeof(int) * refs->capacity);
+    if (trace == nullptr && window > 0) {
+        refs->link = (long*)malloc(sizeof(long) * refs->capacity);
+        refs->pending = new unordered_map<int, refRange>();
+    }
+    if (refs->window == nullptr || (refs->pending != nullptr && refs->link == nullptr) ||
+        (trace != nullptr && window > 0 && !buildTraceNextUse(refs))) {
+        refFree(refs);
+        refs->eof = true;
+        return false;
+    }
+    return true;
+}
+// nextDist 为 nullptr 时没有下次访问索引，OPT 视所有页面为不再访问
+void refInitMem(refStream* refs, const int* mem, long size, const uint32_t* nextDist)
+{
+    refReset(refs);
+    refs->mem = mem;
+    refs->memSize = size;
+    refs->nextDist = nextDist;
+}
+void refFree(refStream* refs)
+{
+    free(refs->window);
+    free(refs->link);
+    delete refs->pending;
+    if (refs->distBytes > 0) munmap(refs->ownDist, refs->distBytes);
+    else free(refs->ownDist);
+    refs->window = nullptr;
+    refs->link = nullptr;
+    refs->pending = nullptr;
+    refs->ownDist = nullptr;
+    refs->nextDist = nullptr;
+    refs->distBytes = 0;
+}
+// 窗口末尾读入一个访问，并接到同一页面上一次出现的后面
+static bool refAppend(refStream* refs)
+{
+    long slot = (refs->head + refs->count) & (refs->capacity - 1);
+    long at = refs->pos + refs->count;
+    if (!readRef(refs, &refs->window[slot])) return false;
+    refs->link[slot] = -1;
+    auto it = refs->pending->find(refs->window[slot]);
+    if (it != refs->pending->end()) {
+        refs->link[it->second.last & (refs->capacity - 1)] = at;
+        it->second.last = at;
+    } else {
+        refRange range = {at, at};
+        refs->pending->emplace(refs->window[slot], range);
+    }
+    refs->count++;
+    return true;
+}
+bool refNext(refStream* refs, int* page)
+{
+    if (refs->mem != nullptr) {
+        if (refs->memPos >= refs->memSize) return false;
+        *page = refs->mem[refs->memPos++];
+        refs->pos++;
+        return true;
+    }
+    if (refs->pending != nullptr) {
+        // 前瞻窗口：保持窗口中有当前访问之后的 capacity 个访问
+        while (refs->count < refs->capacity && refAppend(refs)) {}
+        if (refs->count == 0) return false;
+        *page = refs->window[refs->head];
+        auto it = refs->pending->find(*page);
+        if (refs->link[refs->head] < 0) refs->pending->erase(it);
+        else it->second.first = refs->link[refs->head];
+        refs->head = (refs->head + 1) & (refs->capacity - 1);
+        refs->count--;
+        refs->pos++;
+        refAppend(refs);
+        return true;
+    }
+    if (refs->count == 0) {
+        if (!readRef(refs, &refs->window[refs->head])) return false;
+        refs->count = 1;
+    }
+    *page = refs->window[refs->head];
+    refs->head = (refs->head + 1) & (refs->capacity - 1);
+    refs->count--;
+    refs->pos++;
+    return true;
+}
+// 从后向前扫描 pages[0, len)（位于序列的 base 处），nextPos 为各页面在之后的第一次出现位置
+static void fillNextUse(const int* pages, long len, long base, uint32_t* nextDist, unordered_map<int, long>* nextPos)
+{
+    for (long i = len - 1; i >= 0; i--) {
+        long at = base + i;
+        auto it = nextPos->find(pages[i]);
+        if (it == nextPos->end()) {
+            nextDist[at] = 0;
+            nextPos->emplace(pages[i], at);
+        } else {
+            nextDist[at] = it->second - at <= (long)UINT32_MAX ? (uint32_t)(it->second - at) : 0;
+            it->second = at;
+        }
+    }
+}
+void buildNextUse(const int* mem, long size, uint32_t* nextDist)
+{
+    unordered_map<int, long> nextPos;
+    fillNextUse(mem, size, 0, nextDist, &nextPos);
+}
+/*
+ * 二进制序列的下次访问索引:
+ *  第一遍顺序解码，每 TRACE_CHUNK 个访问保存一次解码状态；第二遍从最后一块开始，
+ *  逐块解码到缓冲区后从后向前扫描。索引写入临时文件的映射，由内核换出。无法创建映射时返回 false。
+ */
+static bool buildTraceNextUse(refStream* refs)
+{
+    vector<traceReader> marks;
+    traceReader scan = *refs->trace;
+    int64_t value = 0;
+    long size = 0;
+    for (;; size++) {
+        if (size % TRACE_CHUNK == 0) marks.push_back(scan);
+        if (!traceNext(&scan, &value)) break;
+    }
+    refs->distBytes = sizeof(uint32_t) * (size > 0 ? size : 1);
+    FILE* tmp = tmpfile();
+    void* addr = MAP_FAILED;
+    if (tmp != nullptr && ftruncate(fileno(tmp), (off_t)refs->distBytes) == 0)
+        addr = mmap(nullptr, refs->distBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(tmp), 0);
+    if (tmp != nullptr) fclose(tmp);
+    if (addr == MAP_FAILED) {
+        refs->distBytes = 0;
+        return false;
+    }
+    refs->ownDist = (uint32_t*)addr;
+    unordered_map<int, long> nextPos;
+    vector<int> chunk;
+    for (size_t k = marks.size(); k-- > 0; ) {
+        long base = (long)k * TRACE_CHUNK;
+        long len = min((long)TRACE_CHUNK, size - base);
+        scan = marks[k];
+        chunk.resize(len > 0 ? len : 0);
+        for (long i = 0; i < len; i++) {
+            traceNext(&scan, &value);
+            chunk[i] = (int)value;
         }
+        if (len > 0) fillNextUse(&chunk[0], len, base, refs->ownDist, &nextPos);
+    }
+    refs->nextDist = refs->ownDist;
+    return true;
+}
+// 页面 page 最近一次在 lastUse 处被访问，返回其下一次访问的位置，不再访问时返回 FAR_POSITION
+long refNextUse(refStream* refs, int page, long lastUse)
+{
+    if (refs->pending != nullptr) {
+        auto it = refs->pending->find(page);
+        return it != refs->pending->end() ? it->second.first : FAR_POSITION;
+    }
+    if (refs->nextDist == nullptr) return FAR_POSITION;
+    uint32_t dist = refs->nextDist[lastUse];
+    return dist > 0 ? lastUse + dist : FAR_POSITION;
+}
+// 在补齐到 N 的页号数组中查找 pid，返回第一个匹配的下标，没有则返回 -1
+template <int N>
+int findFrame(const int* pids, int pid)
+{
+#if defined(__AVX2__)
+    const __m256i key = _mm256_set1_epi32(pid);
+    uint64_t mask = 0;
+    for (int i = 0; i < N; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)(pids + i)), key);
+        mask |= (uint64_t)(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)) << i;
+    }
+    return mask ? __builtin_ctzll(mask) : -1;
+#elif defined(__SSE2__)
+    const __m128i key = _mm_set1_epi32(pid);
+    uint64_t mask = 0;
+    for (int i = 0; i < N; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)(pids + i)), key);
+        mask |= (uint64_t)(unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq)) << i;
+    }
+    return mask ? __builtin_ctzll(mask) : -1;
+#else
+    for (int i = 0; i < N; i++)
+        if (pids[i] == pid) return i;
+    return -1;
+#endif
+}
+// 大驻留集：按 64 个页框一组查找
+int findFrameLarge(const int* pids, int capacity, int pid)
+{
+    for (int i = 0; i < capacity; i += SMALL_FRAMES) {
+        int index = findFrame<SMALL_FRAMES>(pids + i, pid);
+        if (index >= 0) return i + index;
+    }
+    return -1;
+}
+// 分配页框表，内存不足时返回 nullptr
+frameTable* frameAlloc(int pagesNum)
+{
+    auto* ft = (frameTable*)malloc(sizeof(frameTable));
+    void* pids = nullptr;
+    if (ft == nullptr) return nullptr;
+    // 页号数组按 SIMD 宽度对齐并补齐：不超过 64 时取 2 的幂（至少 8），否则取 64 的倍数
+    int capacity = SIMD_LANES;
+    while (capacity < pagesNum && capacity < SMALL_FRAMES) capacity <<= 1;
+    if (pagesNum > SMALL_FRAMES) capacity = (pagesNum + SMALL_FRAMES - 1) / SMALL_FRAMES * SMALL_FRAMES;
+    ft->frames = (residentSet*)malloc(sizeof(residentSet) * pagesNum);
+    if (ft->frames == nullptr || posix_memalign(&pids, SIMD_ALIGN, sizeof(int) * capacity) != 0) {
+        free(ft->frames);
+        free(ft);
+        return nullptr;
     }
-    // 选择最大距离
-    maxDistance = rSet[0].distance;
-    for (int i = 0; i < pageNum; i++) {
-        if (rSet[i].distance > maxDistance ||
-            (rSet[i].distance == maxDistance && rSet[i].priority > rSet[tmpIndex].priority)) {
-            maxDistance = rSet[i].distance;
+    ft->pids = (int*)pids;
+    ft->capacity = capacity;
+    ft->pagesNum = pagesNum;
+    ft->used = 0;
+    ft->loads = 0;
+    ft->hand = 0;
+    ft->victim = -1;
+    for (int i = 0; i < capacity; i++) {
+        ft->pids[i] = i < pagesNum ? -1 : PAD_PID;
+    }
+    for (int i = 0; i < pagesNum; i++) {
+        ft->frames[i].loadSeq = -1;
+        ft->frames[i].lastUse = -1;
+        ft->frames[i].refBit = 0;
+    }
+    return ft;
+}
+void frameFree(frameTable* ft)
+{
+    free(ft->pids);
+    free(ft->frames);
+    free(ft);
+}
+
+void pageAdd(frameTable* ft, int freePage, int currPage)
+{
+    residentSet* rSet = ft->frames;
+    // 空闲页框总在末尾，freePage 即 used
+    ft->pids[freePage] = currPage;
+    rSet[freePage].loadSeq = ft->loads++;
+    rSet[freePage].refBit = 1;
+    ft->used++;
+}
+void updateLRU(frameTable* ft, int hitPage)
+{
+    residentSet* rSet = ft->frames;
+    // 页面按装入顺序占用页框，空闲页均在末尾
+    int used = ft->used;
+    // 命中页移到已用页的末尾（最近使用）
+    residentSet tmp = rSet[hitPage];
+    int tmpPid = ft->pids[hitPage];
+    memmove(&rSet[hitPage], &rSet[hitPage+1], sizeof(residentSet) * (used - hitPage - 1));
+    memmove(&ft->pids[hitPage], &ft->pids[hitPage+1], sizeof(int) * (used - hitPage - 1));
+    rSet[used-1] = tmp;
+    ft->pids[used-1] = tmpPid;
+}
+void updateCLOCK(frameTable* ft, int hitPage)
+{
+    ft->frames[hitPage].refBit = 1;
+}
+void replaceOPT(frameTable* ft, int currPage, refStream* refs)
+{
+    residentSet* rSet = ft->frames;
+    int tmpIndex = 0;                           // 临时下标
+    long maxNext = -1;                          // 最晚的下次访问位置
+    // 选择下次访问最晚的页面；都不再访问时淘汰装入最早的页面
+    for (int i = 0; i < ft->pagesNum; i++) {
+        long next = refNextUse(refs, ft->pids[i], rSet[i].lastUse);
+        if (next > maxNext || (next == maxNext && rSet[i].loadSeq < rSet[tmpIndex].loadSeq)) {
+            maxNext = next;
             tmpIndex = i;
         }
     }
-    rSet[tmpIndex].pid = procSeq[currProc];
-    rSet[tmpIndex].priority = 0;
+    ft->victim = ft->pids[tmpIndex];
+    ft->pids[tmpIndex] = currPage;
+    rSet[tmpIndex].loadSeq = ft->loads++;
+    rSet[tmpIndex].lastUse = refs->pos - 1;
+}
+void replaceFIFO(frameTable* ft, int currPage, refStream* refs)
+{
+    // 页框按 0..pagesNum-1 的顺序装满，此后每次替换的都是最早装入的页面，淘汰顺序轮转
+    ft->victim = ft->pids[ft->hand];
+    ft->pids[ft->hand] = currPage;
+    ft->frames[ft->hand].loadSeq = ft->loads++;
+    ft->hand = ft->hand + 1 < ft->pagesNum ? ft->hand + 1 : 0;
 }
-void replaceFIFO(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc)
+void replaceLRU(frameTable* ft, int currPage, refStream* refs)
 {
-    int toReplace = 0;
-    // 驻留集中已有页优先级调整
-    for (int i = 0; i < pageNum; i++)
-        if (rSet[i].pid != -1)
-            rSet[i].priority += 1;
-    // 寻找优先级最低的页面
-    for (int i = 0; i < pageNum; i++)
-        if (rSet[i].priority > rSet[toReplace].priority)
-            toReplace = i;
-    // 替换
-    rSet[toReplace].pid = procSeq[currProc];
-    rSet[toReplace].priority = 0;
+    residentSet* rSet = ft->frames;
+    // 淘汰最久未使用的页面（首位），新页面放在末尾
+    ft->victim = ft->pids[0];
+    memmove(&rSet[0], &rSet[1], sizeof(residentSet) * (ft->pagesNum - 1));
+    memmove(&ft->pids[0], &ft->pids[1], sizeof(int) * (ft->pagesNum - 1));
+    ft->pids[ft->pagesNum - 1] = currPage;
 }
-void replaceLRU(residentSet* rSet, int pageNum, const int* procSeq, int procNum, int currProc)
+void replaceCLOCK(frameTable* ft, int currPage, refStream* refs)
 {
-    for (int i = 0; i < pageNum; i++) {
-        rSet[i] = rSet[i+1];
+    residentSet* rSet = ft->frames;
+    // 访问位为 1 的页面获得第二次机会
+    while (rSet[ft->hand].refBit) {
+        rSet[ft->hand].refBit = 0;
+        ft->hand = (ft->hand + 1) % ft->pagesNum;
     }
-    rSet[pageNum - 1].pid = procSeq[currProc];
+    ft->victim = ft->pids[ft->hand];
+    ft->pids[ft->hand] = currPage;
+    rSet[ft->hand].refBit = 1;
+    ft->hand = (ft->hand + 1) % ft->pagesNum;
 }
@@ -1,169 +1,1145 @@
 #include<cstdio>
 #include<cstdlib>
+#include<cstring>
 #include<algorithm>
+#include<vector>
+#include<set>
+#include<map>
+#include<deque>
+#include<unordered_map>
+#include<climits>
+#include<cmath>
+#include<cinttypes>
+#include<thread>
+#include "OSSim.h"
 
-#define MAX_SIZE 65535
+#define DEFAULT_STEP_SIZE 10                                // N 步扫描法默认每组请求数
+#define DEFAULT_SETTLE 1.0                                  // 默认稳定时间(ms)
+#define DEFAULT_PER_TRACK 0.01                              // 默认每磁道移动时间(ms)
+#define DEFAULT_SQRT_COEF 0.1                               // 默认短距离寻道 sqrt 系数(ms)
+#define DEFAULT_BOUNDARY 400                                // 默认短/长距离寻道分界(磁道)
+#define DEFAULT_SECTORS 500                                 // 默认每磁道扇区数
+#define DEFAULT_READ_EXPIRE 500.0                           // 截止时间调度默认读请求期限(ms)
+#define DEFAULT_WRITE_EXPIRE 5000.0                         // 截止时间调度默认写请求期限(ms)
+#define DEADLINE_FIFO_BATCH 16                              // 截止时间调度每批最多连续服务的请求数
+#define DEADLINE_WRITES_STARVED 2                           // 写请求最多连续让位给读请求的批数
+#define DEFAULT_BUDGET 256                                  // 公平排队默认预算(扇区)
+#define BUDGET_TIMEOUT 125.0                                // 公平排队每次选中进程的最长服务时间(ms)
+#define DEFAULT_MERGE_WINDOW 1.0                            // 默认请求合并窗口(ms)
+#define MAX_MERGE_SECTORS 1024                              // 合并后请求的最大扇区数
+#define RAID_MAX_ROUNDS 256                                 // 磁盘阵列模式读-改-写释放时刻的最多迭代轮数
 
 using namespace std;
 
-enum diskScheduleAlg {_FCFS = 1, _SSTF, _SCAN, _CSCAN};     // 磁盘调度算法标签
-enum taskState {UNFINISHED, FINISHED};                      // 磁道访问任务状态
-
-struct dSeekTask {                                          // 寻道任务结构体
-    int track;                                              // 目标磁道
-    int distance;                                           // 当前磁道到目标磁道的距离
-    taskState state;                                        // 任务状态
-} tasks[MAX_SIZE];                                          // 任务队列
-int sTable[MAX_SIZE];                                       // 任务计划表
-int taskNum;                                                // 任务总数
-int totalTracks;                                            // 总寻道数
-
-void FCFS();                                                // 先来先服务
-void SSTF();                                                // 最短寻道时间优先
-void SCAN(int mvDirection);                                 // 扫描法
-void CSCAN(int mvDirection);                                // 循环扫描法
-int getDistance(int x, int y);                              // 距离计算函数
-void output();                                              // 输出结果函数
+// 距离计算函数
+static uint64_t getDistance(uint64_t x, uint64_t y);
+static bool readTrack(uint64_t* track, bool* invalid);
+static int runOnline(const onlineConfig* base, bool online, const char* tracePath, FILE* out);
+static int runImport(const onlineConfig* base, bool online, const blkImport* imp, FILE* out);
+static int runRaid(const onlineConfig* base, const raidLayout* layout, FILE* out);
 
-int main() {
+int diskScheduleMain(int argc, char* argv[]) {
+    // 0. 读取命令行参数：-t 二进制磁道请求序列文件，-d 磁盘柱面数，-n N 步扫描法每组请求数
+    //    -o 在线模式，-S 稳定时间(ms)，-T 每磁道移动时间(ms)
+    //    -C 使用非线性寻道曲线，-Q sqrt 系数(ms)，-B 短/长距离分界，-R 转速，-P 每磁道扇区数，-X 传输扇区数
+    //    -A 级别,磁盘数,条带单元：磁盘阵列模式
+    //    -I blkparse 记录文件，-G 磁头数，-M 合并窗口(ms)，-E 采用的事件类型
+    //    -D 读期限,写期限(ms)：截止时间调度，-U 预算(扇区)：公平排队
+    const char* tracePath = nullptr;
+    bool online = false;
+    uint64_t diskSize = 0;                                  // 磁盘柱面数(-d)，0 表示未指定
+    int stepSize = DEFAULT_STEP_SIZE;                       // N 步扫描法每组请求数(-n)
+    double readExpire = DEFAULT_READ_EXPIRE;                // 截止时间调度读请求期限(-D)
+    double writeExpire = DEFAULT_WRITE_EXPIRE;              // 截止时间调度写请求期限(-D)
+    uint64_t budget = DEFAULT_BUDGET;                       // 公平排队预算(-U)
+    DiskScheduler sched;
+    raidLayout layout = {-1, 0, 0};
+    blkImport imp = {nullptr, 1, DEFAULT_MERGE_WINDOW, 'Q'};
+    diskModel model = {linearSeek, DEFAULT_SETTLE, DEFAULT_PER_TRACK, DEFAULT_SQRT_COEF, DEFAULT_BOUNDARY,
+                       0.0, DEFAULT_SECTORS, 1};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            diskSize = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            stepSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0) {
+            online = true;
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            model.settle = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            model.perTrack = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-C") == 0) {
+            model.seek = curveSeek;
+        } else if (strcmp(argv[i], "-Q") == 0 && i + 1 < argc) {
+            model.sqrtCoef = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+            model.boundary = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc) {
+            model.rpm = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            model.sectorsPerTrack = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-X") == 0 && i + 1 < argc) {
+            model.transferSectors = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-I") == 0 && i + 1 < argc) {
+            imp.path = argv[++i];
+        } else if (strcmp(argv[i], "-G") == 0 && i + 1 < argc) {
+            imp.heads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            imp.mergeWindow = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-E") == 0 && i + 1 < argc) {
+            imp.action = argv[++i][0];
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%lf,%lf", &readExpire, &writeExpire) != 2) {
+                printf("Invalid expire times.");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-U") == 0 && i + 1 < argc) {
+            budget = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-A") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d,%d", &layout.level, &layout.disks, &layout.stripe) != 3 ||
+                !(layout.level == 0 || layout.level == 1 || layout.level == 5) || layout.stripe < 1 ||
+                layout.disks < (layout.level == 5 ? 3 : 1)) {
+                printf("Invalid RAID layout.");
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            printf("Usage: %s [-t trace.bin] [-d cylinders] [-n step] [-o] [-S settle] [-T perTrack]"
+                   " [-C [-Q sqrtCoef] [-B boundary]] [-R rpm [-P sectors] [-X transfer]] [-A level,disks,stripe]"
+                   " [-I blkparse.txt [-G heads] [-M window] [-E action]] [-D readExpire,writeExpire] [-U budget]", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (model.rpm < 0 || model.sectorsPerTrack < 1 || model.transferSectors < 0 || model.boundary < 0 ||
+        imp.heads < 1 || imp.mergeWindow < 0) {
+        printf("Invalid disk model.");
+        exit(EXIT_FAILURE);
+    }
+    if (stepSize < 1 || budget < 1 || readExpire < 0 || writeExpire < 0) {
+        printf("Invalid disk size, step size or scheduler parameters.");
+        exit(EXIT_FAILURE);
+    }
     // 1. 读取算法、当前轨道号以及磁臂移动方向并进行初始化
     int algNum;
-    int position;
+    uint64_t position = 0;
     int direction;
-    taskNum = 0;
-    totalTracks = 0;
-    scanf("%d %d %d", &algNum, &position, &direction);
-    sTable[0] = position;
+    bool invalid = false;
+    scanf("%d", &algNum);
+    readTrack(&position, &invalid);
+    scanf("%d", &direction);
+    if (invalid) {
+        printf("Invalid track number.");
+        exit(EXIT_FAILURE);
+    }
+    onlineConfig cfg = {algNum, position, direction, diskSize, stepSize, readExpire, writeExpire, budget,
+                        model, nullptr, nullptr, nullptr};
+    if (layout.level >= 0) return runRaid(&cfg, &layout, stdout);
+    if (imp.path != nullptr) return runImport(&cfg, online, &imp, stdout);
+    // 在线模式、SPTF、截止时间调度、公平排队和旋转模型都需要按时间模拟
+    if (online || algNum >= _SPTF || model.rpm > 0) return runOnline(&cfg, online, tracePath, stdout);
+    sched.diskSize = diskSize;
+    sched.stepSize = stepSize;
     // 2. 读取磁道请求序列
-    char tmpChar;
-    while (scanf("%d", &tasks[taskNum].track)) {
-        tasks[taskNum].distance = MAX_SIZE;
-        tasks[taskNum].state = UNFINISHED;
-        taskNum++;
-        tmpChar = getchar();
-        if (tmpChar == ',') continue;
-        else if (tmpChar == '\n') break;
+    if (tracePath != nullptr) {
+        // 2.1 从内存映射的二进制文件中解码，序列长度已知，一次分配
+        traceReader trace;
+        int64_t track;
+        if (!traceOpen(&trace, tracePath, TRACE_TRACKS)) {
+            printf("Invalid trace file.");
+            exit(EXIT_FAILURE);
+        }
+        sched.tasks.reserve((size_t)trace.count);
+        while (traceNext(&trace, &track) && !invalid) {
+            invalid = track < 0;
+            sched.add((uint64_t)track);
+        }
+        bool complete = trace.remaining == 0;
+        traceClose(&trace);
+        if (invalid) {
+            printf("Invalid track number.");
+            exit(EXIT_FAILURE);
+        }
+        if (!complete) {
+            printf("Truncated trace file.");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        // 2.2 从标准输入读取文本序列，批处理不模拟旋转，"磁道:扇区" 中的扇区被忽略
+        int tmpChar, sector;
+        uint64_t track;
+        while (readTrack(&track, &invalid)) {
+            sched.add(track);
+            tmpChar = getchar();
+            if (tmpChar == ':') {
+                if (scanf("%d", &sector) != 1) break;
+                tmpChar = getchar();
+            }
+            if (tmpChar == ',') continue;
+            else if (tmpChar == '\n' || tmpChar == EOF) break;
+        }
+        if (invalid) {
+            printf("Invalid track number.");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (diskSize > 0) {
+        for (size_t i = 0; i <= sched.tasks.size(); i++) {
+            uint64_t track = i < sched.tasks.size() ? sched.tasks[i] : position;
+            if (track >= diskSize) {
+                printf("Track out of range.");
+                exit(EXIT_FAILURE);
+            }
+        }
     }
     // 3. 执行算法
+    if (!sched.run(algNum, position, direction)) {
+        printf("Unrecognized Algorithm.");
+        exit(EXIT_FAILURE);
+    }
+    // 4. 输出结果
+    sched.output();
+    return 0;
+}
+DiskScheduler::DiskScheduler(FILE* out)
+    : taskNum(0), totalTracks(0), sTag(0), position(0), headPos(0), diskSize(0), stepSize(DEFAULT_STEP_SIZE), out(out) {}
+void DiskScheduler::add(uint64_t track) {
+    tasks.push_back(track);
+}
+bool DiskScheduler::run(int algNum, uint64_t position, int direction) {
+    taskNum = tasks.size();
+    sTag = 0;
+    this->position = position;
+    headPos = position;
+    totalTracks = 0;
     switch (algNum) {
         case _FCFS: FCFS(); break;
         case _SSTF: SSTF(); break;
         case _SCAN: SCAN(direction); break;
         case _CSCAN: CSCAN(direction); break;
+        case _LOOK: LOOK(direction); break;
+        case _CLOOK: CLOOK(direction); break;
+        case _NSCAN: NSCAN(direction); break;
+        case _FSCAN: FSCAN(direction); break;
+        default: return false;
     }
-    // 4. 输出结果
-    output();
-    return 0;
+    return true;
 }
 // 距离计算函数
-int getDistance(int x, int y) {
-    return abs(x-y);
+static uint64_t getDistance(uint64_t x, uint64_t y) {
+    return x > y ? x - y : y - x;
 }
-// 先来先服务
-void FCFS() {
-    for (int i = 0; i < taskNum; i++) {
-        sTable[i+1] = tasks[i].track;
-        tasks[i].state = FINISHED;
-        totalTracks += getDistance(sTable[i], tasks[i].track);
+// 读取一个磁道号，与 scanf("%" SCNu64) 相同，但负数不回绕成很大的磁道号，而是置 *invalid 并返回 false
+static bool readTrack(uint64_t* track, bool* invalid) {
+    int c;
+    do { c = getchar(); } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    if (c == '-') {
+        *invalid = true;
+        return false;
     }
+    ungetc(c, stdin);
+    return scanf("%" SCNu64, track) == 1;
+}
+// 先来先服务：输入次序即服务顺序
+void DiskScheduler::FCFS() {
+    for (size_t i = 0; i < taskNum; i++) serve(i);
 }
 // 最短寻道时间优先
-void SSTF() {
-    // 外层循环用来完成sTable的构建，内层循环用于选择距离最近的磁道
-    for (int i = 1; i <= taskNum; i++) {
-        // 寻找当前距离最小的磁道
-        int minDis = MAX_SIZE;
-        int tmpDis = MAX_SIZE;
-        int tag = 0;
-        for (int j = 0; j < taskNum; j++) {
-            if (tasks[j].state == UNFINISHED) {
-                tmpDis = getDistance(sTable[i-1], tasks[j].track);
-                if (tmpDis < minDis) {
-                    minDis = tmpDis;
-                    tag = j;
-                }
-            }
+void DiskScheduler::SSTF() {
+    /*
+     * 1. 复制磁道号排序去重，相同磁道合并为一组，剩余的组用双向链表串起来。
+     *    磁头两侧最近的剩余磁道就是链表中相邻的 left 和 right，每一步只需比较这两组，
+     *    总复杂度 O(n log n)。距离相同时与逐个比较的结果一致：选择输入次序靠前的请求；
+     *    磁头到达某磁道后，同一磁道的其余请求距离为 0，会被立即连续处理。
+     *    组的计数、最早输入次序和链表都用 32 位下标，每组 16 字节。
+     */
+    typedef uint32_t group;
+    vector<uint64_t> gTrack(tasks);             // 组的磁道
+    sort(gTrack.begin(), gTrack.end());
+    gTrack.erase(unique(gTrack.begin(), gTrack.end()), gTrack.end());
+    vector<uint64_t>(gTrack).swap(gTrack);
+    group groupNum = (group)gTrack.size();
+    vector<group> gCount(groupNum, 0);          // 组的请求数
+    vector<group> gFirst(groupNum, 0);          // 组的最早输入次序
+    for (size_t i = 0; i < taskNum; i++) {
+        group g = (group)(lower_bound(gTrack.begin(), gTrack.end(), tasks[i]) - gTrack.begin());
+        if (gCount[g]++ == 0) gFirst[g] = (group)i;
+    }
+    const group NONE = (group)-1;
+    vector<group> prev(groupNum), next(groupNum); // 剩余组的双向链表，NONE 表示没有
+    for (group g = 0; g < groupNum; g++) {
+        prev[g] = g > 0 ? g - 1 : NONE;
+        next[g] = g + 1 < groupNum ? g + 1 : NONE;
+    }
+    // 2. 定位磁头两侧最近的组
+    group right = (group)(lower_bound(gTrack.begin(), gTrack.end(), headPos) - gTrack.begin());
+    group left = right > 0 ? right - 1 : NONE;
+    if (right == groupNum) right = NONE;
+    // 3. 每次在两侧中选择距离较近的组，服务顺序依次写回 tasks
+    while (left != NONE || right != NONE) {
+        group tag;
+        if (left == NONE) {
+            tag = right;
+        } else if (right == NONE) {
+            tag = left;
+        } else {
+            uint64_t disL = getDistance(headPos, gTrack[left]);
+            uint64_t disR = getDistance(headPos, gTrack[right]);
+            tag = (disL < disR || (disL == disR && gFirst[left] < gFirst[right])) ? left : right;
+        }
+        for (group c = 0; c < gCount[tag]; c++) {
+            tasks[sTag] = gTrack[tag];
+            serve(sTag);
         }
-        sTable[i] = tasks[tag].track;
-        tasks[tag].state = FINISHED;
-        totalTracks += minDis;
+        // 从链表中删除该组，其前后组成为新的两侧
+        left = prev[tag];
+        right = next[tag];
+        if (left != NONE) next[left] = right;
+        if (right != NONE) prev[right] = left;
     }
 }
-// 扫描法
-void SCAN(int mvDirection) {
-    // 1. 排序
+// 服务 tasks[i]：累计寻道数，tasks[0, sTag) 为已排定的服务顺序
+void DiskScheduler::serve(size_t i) {
+    totalTracks += getDistance(headPos, tasks[i]);
+    headPos = tasks[i];
+    sTag++;
+}
+// 磁头移动到指定磁道（不服务请求）
+void DiskScheduler::moveTo(uint64_t track) {
+    totalTracks += getDistance(headPos, track);
+    headPos = track;
+}
+/*
+ * 对 tasks[first, last) 执行一次扫描，返回扫描结束时的磁臂移动方向。
+ *  按磁道升序排序后以磁头位置为界分成两侧，与磁头同一磁道的请求归入先扫描的一侧：
+ *      mvDirection == 0: 先向磁道号减小方向扫描 [first, split)，split 为第一个大于磁头的位置；
+ *      mvDirection == 1: 先向磁道号增大方向扫描 [split, last)，split 为第一个不小于磁头的位置。
+ *  另一侧还有请求时：
+ *      toEdge: 先移动到磁盘边界（0 或 diskSize - 1）再折返，否则在最后一个请求处折返；
+ *      circular: 不折返，回到另一端（跳转距离计入寻道数）后按原方向继续扫描。
+ *  两侧各自逆序或轮转，使 tasks[first, last) 就地成为服务顺序。
+ */
+int DiskScheduler::sweep(size_t first, size_t last, int mvDirection, bool circular, bool toEdge) {
+    // 1. 排序并获取分隔下标
+    vector<uint64_t>::iterator begin = tasks.begin() + first, end = tasks.begin() + last;
+    sort(begin, end);
+    vector<uint64_t>::iterator split = mvDirection == 0 ? upper_bound(begin, end, headPos) : lower_bound(begin, end, headPos);
+    // 2. 就地排成服务顺序，turn 为第二侧的起点
+    size_t turn;
     if (mvDirection == 0) {
-        sort(tasks, tasks + taskNum, [] (dSeekTask a, dSeekTask b) { return a.track < b.track; });
-    } else if (mvDirection == 1) {
-        sort(tasks, tasks + taskNum, [] (dSeekTask a, dSeekTask b) { return a.track > b.track; });
-    }
-    // 2. 获取分隔下标
-    int tag = 0;
-    for (int i = 0; i < taskNum; i++) {
-        if (mvDirection==0 && tasks[i].track > sTable[0]) {
-            tag = i;
+        reverse(begin, split);
+        if (circular) reverse(split, end);
+        turn = (size_t)(split - tasks.begin());
+    } else {
+        if (!circular) reverse(begin, split);
+        turn = first + (size_t)(end - split);
+        rotate(begin, split, end);
+    }
+    // 3. 依次服务
+    for (size_t i = first; i < turn; i++) serve(i);
+    if (turn == last) return mvDirection;
+    if (toEdge) moveTo(mvDirection == 0 ? 0 : diskSize - 1);
+    if (circular && toEdge) moveTo(mvDirection == 0 ? diskSize - 1 : 0);
+    for (size_t i = turn; i < last; i++) serve(i);
+    return circular ? mvDirection : 1 - mvDirection;
+}
+// 扫描法：指定磁盘大小时到达磁盘边界才折返，否则与 LOOK 相同
+void DiskScheduler::SCAN(int mvDirection) {
+    sweep(0, taskNum, mvDirection, false, diskSize > 0);
+}
+// 循环扫描法：指定磁盘大小时扫描到磁盘边界再跳回另一端，否则与 C-LOOK 相同
+void DiskScheduler::CSCAN(int mvDirection) {
+    sweep(0, taskNum, mvDirection, true, diskSize > 0);
+}
+// LOOK：在最后一个请求处折返
+void DiskScheduler::LOOK(int mvDirection) {
+    sweep(0, taskNum, mvDirection, false, false);
+}
+// C-LOOK：到达最后一个请求后跳到另一端的第一个请求
+void DiskScheduler::CLOOK(int mvDirection) {
+    sweep(0, taskNum, mvDirection, true, false);
+}
+// N 步扫描法：按到达次序每 stepSize 个请求一组，逐组扫描，组内新请求不会插队
+void DiskScheduler::NSCAN(int mvDirection) {
+    for (size_t first = 0; first < taskNum; first += stepSize) {
+        mvDirection = sweep(first, min(first + stepSize, taskNum), mvDirection, false, diskSize > 0);
+    }
+}
+// FSCAN：扫描开始时冻结当前队列，扫描期间到达的请求进入另一队列；请求全部在 0 时刻到达时只有一次扫描
+void DiskScheduler::FSCAN(int mvDirection) {
+    sweep(0, taskNum, mvDirection, false, diskSize > 0);
+}
+/*
+ * 在线模式:
+ *  每个请求带有到达时刻，磁头按寻道时间模型移动。每次调度时只在已到达的请求中选择，
+ *  因此每个新到达的请求都会参与下一次调度决策（等价于到达即重新规划）；正在进行的
+ *  寻道不会被打断。所有状态都在局部变量中，可在多个线程中同时运行。
+ */
+typedef set<pair<uint64_t, int> > trackQueue;               // (磁道, 请求编号)，编号即到达次序
+struct budgetQueue {                                        // 公平排队的进程队列
+    trackQueue q;                                           // 该进程的请求
+    double start;                                           // 虚拟开始时间
+    double finish;                                          // 虚拟结束时间
+};
+struct onlineState {
+    trackQueue active;                                      // 可调度的请求
+    deque<int> waiting;                                     // N 步扫描法/FSCAN 的等待队列
+    deque<int> fifo;                                        // 先来先服务队列
+    trackQueue sorted[2];                                   // 截止时间调度：读/写排序队列
+    set<int> expiry[2];                                     // 截止时间调度：读/写 FIFO
+    int dataDir;                                            // 截止时间调度：当前批次方向
+    int batching;                                           // 截止时间调度：当前批次已服务数
+    int starved;                                            // 截止时间调度：写请求连续让位批数
+    map<int, budgetQueue> procs;                            // 公平排队：进程号 -> 队列
+    int inService;                                          // 公平排队：当前进程，-1 表示无
+    uint64_t consumed;                                      // 公平排队：当前进程已消耗的预算
+    double slotStart;                                       // 公平排队：当前进程被选中的时刻
+    double vtime;                                           // 公平排队：系统虚拟时间
+    size_t queued;                                          // 已到达未服务的请求数
+    uint64_t head;                                          // 磁头位置
+    int direction;                                          // 磁臂移动方向
+    double clock;                                           // 当前时刻(ms)
+    uint64_t tracks;                                        // 总寻道数
+};
+// 线性寻道：磁头不动时为 0，否则为稳定时间加每磁道移动时间
+double linearSeek(const diskModel* model, long long distance) {
+    return distance > 0 ? model->settle + model->perTrack * distance : 0.0;
+}
+// 非线性寻道：短距离以加速为主，时间与距离的平方根成正比；长距离以匀速为主，线性增长
+double curveSeek(const diskModel* model, long long distance) {
+    if (distance <= 0) return 0.0;
+    if (distance < model->boundary) return model->settle + model->sqrtCoef * sqrt((double)distance);
+    return model->settle + model->sqrtCoef * sqrt((double)model->boundary) + model->perTrack * (distance - model->boundary);
+}
+// 旋转延迟：clock 时刻开始等待，直到目标扇区转到磁头下
+double rotationalWait(const diskModel* model, double clock, int sector) {
+    if (model->rpm <= 0) return 0.0;
+    double period = 60000.0 / model->rpm;
+    double angle = fmod(clock, period) / period;
+    double target = (double)(sector % model->sectorsPerTrack) / model->sectorsPerTrack;
+    double diff = target - angle;
+    if (diff < 0) diff += 1.0;
+    return diff * period;
+}
+double transferTime(const diskModel* model, int sectors) {
+    if (model->rpm <= 0) return 0.0;
+    return 60000.0 / model->rpm * (sectors > 0 ? sectors : model->transferSectors) / model->sectorsPerTrack;
+}
+static void travel(onlineState* st, const onlineConfig* cfg, uint64_t track) {
+    uint64_t distance = getDistance(st->head, track);
+    st->tracks += distance;
+    st->clock += cfg->model.seek(&cfg->model, distance);
+    st->head = track;
+}
+// 磁道号不小于 head 的最近请求
+static trackQueue::iterator nearestUp(trackQueue& q, uint64_t head) {
+    return q.lower_bound(make_pair(head, INT_MIN));
+}
+// 磁道号不大于 head 的最近请求，同一磁道取最早到达的
+static trackQueue::iterator nearestDown(trackQueue& q, uint64_t head) {
+    auto it = q.upper_bound(make_pair(head, INT_MAX));
+    if (it == q.begin()) return q.end();
+    --it;
+    return q.lower_bound(make_pair(it->first, INT_MIN));
+}
+/*
+ * 截止时间调度（与 Linux deadline 调度器相同的结构）:
+ *  读、写请求各有一个按磁道排序的队列和一个按到达次序排列的 FIFO。每批沿磁道号增大方向
+ *  连续服务同一方向的请求，最多 DEADLINE_FIFO_BATCH 个；批次结束后重新选择方向：有读请求时
+ *  优先读，但写请求已连续 DEADLINE_WRITES_STARVED 次让位时改为写。新批次从磁头之后的
+ *  下一个请求开始，若该方向 FIFO 队首已超过截止时间（到达时刻 + readExpire/writeExpire），
+ *  或磁头之后没有请求，则从 FIFO 队首开始。
+ */
+static int pickDeadline(onlineState* st, const onlineConfig* cfg) {
+    trackQueue::iterator it = st->sorted[st->dataDir].end();
+    if (st->batching > 0 && st->batching < DEADLINE_FIFO_BATCH)
+        it = nearestUp(st->sorted[st->dataDir], st->head);
+    if (it == st->sorted[st->dataDir].end()) {
+        // 选择方向
+        bool reads = !st->sorted[0].empty();
+        bool writes = !st->sorted[1].empty();
+        if (reads && !(writes && st->starved++ >= DEADLINE_WRITES_STARVED)) {
+            st->dataDir = 0;
+        } else {
+            st->dataDir = 1;
+            st->starved = 0;
+        }
+        trackQueue& q = st->sorted[st->dataDir];
+        int oldest = *st->expiry[st->dataDir].begin();
+        double expire = st->dataDir ? cfg->writeExpire : cfg->readExpire;
+        it = nearestUp(q, st->head);
+        if (it == q.end() || cfg->reqs[oldest].arrival + expire <= st->clock)
+            it = q.find(make_pair(cfg->tracks[oldest], oldest));
+        st->batching = 0;
+    }
+    int id = it->second;
+    st->batching++;
+    st->sorted[st->dataDir].erase(it);
+    st->expiry[st->dataDir].erase(id);
+    return id;
+}
+/*
+ * 按预算的公平排队（BFQ 风格）:
+ *  每个进程一个按磁道排序的队列。调度器每次选中一个进程，独占磁盘连续服务它的请求
+ *  （队内按 C-LOOK 次序），直到用完预算（扇区数）、队列为空或服务超过 BUDGET_TIMEOUT。
+ *  进程的选择按 B-WF2Q+：每个进程有虚拟开始时间 S 和结束时间 F = S + 预算，在 S 不大于
+ *  系统虚拟时间 V 的进程中选 F 最小的；进程让出磁盘时按消耗的服务量修正 F，V 按服务量
+ *  除以积压进程数推进。超时让出的进程按整个预算计费，随机访问的进程因此按占用的时间
+ *  而不是传输的扇区数分享磁盘。各进程权重相同，不做空闲等待（anticipation）。
+ */
+static int pickBudget(onlineState* st, const onlineConfig* cfg) {
+    budgetQueue* bq = st->inService >= 0 ? &st->procs[st->inService] : nullptr;
+    bool timeout = st->clock - st->slotStart >= BUDGET_TIMEOUT;
+    if (bq != nullptr && (bq->q.empty() || st->consumed >= cfg->budget || timeout)) {
+        // 让出磁盘：按服务量结算，超时按整个预算结算
+        size_t backlogged = 0;
+        uint64_t charge = timeout ? max(st->consumed, cfg->budget) : st->consumed;
+        for (auto p = st->procs.begin(); p != st->procs.end(); ++p) backlogged += !p->second.q.empty();
+        bq->finish = bq->start + charge;
+        st->vtime += (double)charge / max<size_t>(backlogged, 1);
+        if (!bq->q.empty()) {
+            bq->start = bq->finish;
+            bq->finish = bq->start + cfg->budget;
+        }
+        st->inService = -1;
+        bq = nullptr;
+    }
+    if (bq == nullptr) {
+        // 选择虚拟结束时间最小的合格进程，没有合格进程时推进虚拟时间
+        auto best = st->procs.end();
+        double minStart = HUGE_VAL;                         // 有请求的进程中最小的虚拟开始时间
+        for (auto p = st->procs.begin(); p != st->procs.end(); ++p) {
+            if (p->second.q.empty()) continue;
+            minStart = min(minStart, p->second.start);
+            if (p->second.start <= st->vtime && (best == st->procs.end() || p->second.finish < best->second.finish))
+                best = p;
+        }
+        if (best == st->procs.end()) {
+            st->vtime = minStart;
+            for (auto p = st->procs.begin(); p != st->procs.end(); ++p) {
+                if (!p->second.q.empty() && p->second.start <= st->vtime &&
+                    (best == st->procs.end() || p->second.finish < best->second.finish)) best = p;
+            }
+        }
+        st->inService = best->first;
+        st->consumed = 0;
+        st->slotStart = st->clock;
+        bq = &best->second;
+    }
+    auto it = nearestUp(bq->q, st->head);
+    if (it == bq->q.end()) it = bq->q.begin();
+    int id = it->second;
+    bq->q.erase(it);
+    st->consumed += cfg->reqs[id].sectors > 0 ? cfg->reqs[id].sectors : max(cfg->model.transferSectors, 1);
+    return id;
+}
+// 已到达的请求进入对应队列
+static void enqueue(onlineState* st, const onlineConfig* cfg, int id) {
+    const dTimedTask& req = cfg->reqs[id];
+    switch (cfg->algNum) {
+        case _FCFS: st->fifo.push_back(id); break;
+        case _NSCAN:
+        case _FSCAN: st->waiting.push_back(id); break;
+        case _DEADLINE: {
+            st->sorted[req.write].insert(make_pair(req.track, id));
+            st->expiry[req.write].insert(id);
             break;
-        } else if (mvDirection==1 && tasks[i].track < sTable[0]) {
-            tag = i;
+        }
+        case _BFQ: {
+            budgetQueue& bq = st->procs[req.pid];
+            if (bq.q.empty() && req.pid != st->inService) {
+                bq.start = max(st->vtime, bq.finish);
+                bq.finish = bq.start + cfg->budget;
+            }
+            bq.q.insert(make_pair(req.track, id));
             break;
         }
+        default: st->active.insert(make_pair(req.track, id)); break;
     }
-    // 3. 填表
-    int sTag = 0;
-    for (int i = tag - 1; i >= 0; i--) {
-        sTable[sTag+1] = tasks[i].track;
-        tasks[i].state = FINISHED;
-        totalTracks += getDistance(sTable[sTag], tasks[i].track);
-        sTag++;
+    st->queued++;
+}
+// 选出下一个服务的请求并从队列中删除，扫描类算法可能先移动到磁盘边界
+static int pickNext(onlineState* st, const onlineConfig* cfg) {
+    trackQueue& q = st->active;
+    trackQueue::iterator it;
+    bool toEdge = cfg->diskSize > 0 && (cfg->algNum == _SCAN || cfg->algNum == _CSCAN ||
+                                        cfg->algNum == _NSCAN || cfg->algNum == _FSCAN);
+    if (cfg->algNum == _FCFS) {
+        int id = st->fifo.front();
+        st->fifo.pop_front();
+        return id;
     }
-    for (int i = tag; i < taskNum; i++) {
-        sTable[sTag+1] = tasks[i].track;
-        tasks[i].state = FINISHED;
-        totalTracks += getDistance(sTable[sTag], tasks[i].track);
-        sTag++;
+    if (cfg->algNum == _DEADLINE) return pickDeadline(st, cfg);
+    if (cfg->algNum == _BFQ) return pickBudget(st, cfg);
+    // N 步扫描法/FSCAN：当前队列处理完后才从等待队列中取下一批
+    if ((cfg->algNum == _NSCAN || cfg->algNum == _FSCAN) && q.empty()) {
+        size_t batch = cfg->algNum == _NSCAN ? (size_t)cfg->stepSize : st->waiting.size();
+        for (size_t k = 0; k < batch && !st->waiting.empty(); k++) {
+            int id = st->waiting.front();
+            st->waiting.pop_front();
+            q.insert(make_pair(cfg->tracks[id], id));
+        }
     }
-}
-// 循环扫描法
-void CSCAN(int mvDirection) {
-    // 1. 排序
-    if (mvDirection == 0) {
-        sort(tasks, tasks + taskNum, [] (dSeekTask a, dSeekTask b) { return a.track < b.track; });
-    } else if (mvDirection == 1) {
-        sort(tasks, tasks + taskNum, [] (dSeekTask a, dSeekTask b) { return a.track > b.track; });
-    }
-    // 2. 获取分隔下标
-    int tag = 0;
-    for (int i = 0; i < taskNum; i++) {
-        if (mvDirection==0 && tasks[i].track > sTable[0]) {
-            tag = i;
+    switch (cfg->algNum) {
+        case _SPTF: {
+            // 定位时间 = 寻道时间 + 旋转延迟，逐个计算取最小
+            double best = 0;
+            it = q.end();
+            for (auto k = q.begin(); k != q.end(); ++k) {
+                double seek = cfg->model.seek(&cfg->model, getDistance(st->head, k->first));
+                double cost = seek + rotationalWait(&cfg->model, st->clock + seek, cfg->sectors[k->second]);
+                if (it == q.end() || cost < best || (cost == best && k->second < it->second)) {
+                    best = cost;
+                    it = k;
+                }
+            }
+            break;
+        }
+        case _SSTF: {
+            auto up = nearestUp(q, st->head);
+            auto down = nearestDown(q, st->head);
+            if (up == q.end()) it = down;
+            else if (down == q.end()) it = up;
+            else {
+                uint64_t disUp = getDistance(st->head, up->first);
+                uint64_t disDown = getDistance(st->head, down->first);
+                it = (disUp < disDown || (disUp == disDown && up->second < down->second)) ? up : down;
+            }
+            break;
+        }
+        case _CSCAN:
+        case _CLOOK: {
+            it = st->direction ? nearestUp(q, st->head) : nearestDown(q, st->head);
+            if (it == q.end()) {
+                // 回到另一端继续按原方向扫描
+                if (toEdge) {
+                    travel(st, cfg, st->direction ? cfg->diskSize - 1 : 0);
+                    travel(st, cfg, st->direction ? 0 : cfg->diskSize - 1);
+                }
+                it = st->direction ? q.begin() : nearestDown(q, UINT64_MAX);
+            }
             break;
-        } else if (mvDirection==1 && tasks[i].track < sTable[0]) {
-            tag = i;
+        }
+        default: {
+            it = st->direction ? nearestUp(q, st->head) : nearestDown(q, st->head);
+            if (it == q.end()) {
+                // 当前方向没有请求：折返
+                if (toEdge) travel(st, cfg, st->direction ? cfg->diskSize - 1 : 0);
+                st->direction = !st->direction;
+                it = st->direction ? nearestUp(q, st->head) : nearestDown(q, st->head);
+            }
             break;
         }
     }
-    // 3. 填表
-    int sTag = 0;
-    // 填写分隔符左边的任务
-    for (int i = tag - 1; i >= 0; i--) {
-        sTable[sTag+1] = tasks[i].track;
-        tasks[i].state = FINISHED;
-        totalTracks += getDistance(sTable[sTag], tasks[i].track);
-        sTag++;
+    int id = it->second;
+    q.erase(it);
+    return id;
+}
+void onlineSchedule(vector<dTimedTask>& reqs, const onlineConfig* cfg, onlineResult* res) {
+    onlineState st;
+    size_t n = reqs.size();
+    size_t next = 0;
+    vector<uint64_t> tracks(n);
+    vector<int> sectors(n);
+    onlineConfig local = *cfg;
+    // 1. 按到达时刻排序，编号即到达次序
+    stable_sort(reqs.begin(), reqs.end(), [] (const dTimedTask& a, const dTimedTask& b) { return a.arrival < b.arrival; });
+    for (size_t i = 0; i < n; i++) {
+        tracks[i] = reqs[i].track;
+        sectors[i] = reqs[i].sector;
+    }
+    local.tracks = tracks.empty() ? nullptr : &tracks[0];
+    local.sectors = sectors.empty() ? nullptr : &sectors[0];
+    local.reqs = reqs.empty() ? nullptr : &reqs[0];
+    st.head = cfg->position;
+    st.direction = cfg->direction;
+    st.clock = 0;
+    st.tracks = 0;
+    st.dataDir = 0;
+    st.batching = 0;
+    st.starved = 0;
+    st.inService = -1;
+    st.consumed = 0;
+    st.slotStart = 0;
+    st.vtime = 0;
+    st.queued = 0;
+    res->order.clear();
+    res->order.reserve(n);
+    res->depthHist.clear();
+    // 2. 事件循环：接收已到达的请求，空闲时跳到下一个到达时刻
+    while (res->order.size() < n) {
+        while (next < n && reqs[next].arrival <= st.clock) enqueue(&st, &local, (int)next++);
+        if (st.queued == 0) {
+            st.clock = max(st.clock, reqs[next].arrival);
+            continue;
+        }
+        size_t depth = st.queued;
+        if (res->depthHist.size() <= depth) res->depthHist.resize(depth + 1, 0);
+        res->depthHist[depth]++;
+        double dispatch = st.clock;
+        int id = pickNext(&st, &local);
+        st.queued--;
+        reqs[id].start = dispatch;
+        travel(&st, &local, reqs[id].track);
+        st.clock += rotationalWait(&cfg->model, st.clock, reqs[id].sector) + transferTime(&cfg->model, reqs[id].sectors);
+        reqs[id].finish = st.clock;
+        res->order.push_back(reqs[id].track);
+    }
+    res->totalTracks = st.tracks;
+    res->makespan = st.clock;
+}
+// 百分位数（最近秩法），values 需已排序
+double percentile(const vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t rank = (size_t)ceil(p * values.size());
+    return values[rank > 0 ? rank - 1 : 0];
+}
+void onlineOutput(const vector<dTimedTask>& reqs, const onlineConfig* cfg, const onlineResult* res, FILE* out) {
+    vector<double> latency, wait;
+    double sum = 0;
+    double service = 0;
+    for (size_t i = 0; i < reqs.size(); i++) {
+        latency.push_back(reqs[i].finish - reqs[i].arrival);
+        wait.push_back(reqs[i].start - reqs[i].arrival);
+        sum += latency.back();
+        service += reqs[i].finish - reqs[i].start;
+    }
+    sort(latency.begin(), latency.end());
+    sort(wait.begin(), wait.end());
+    fprintf(out, "%" PRIu64, cfg->position);
+    for (size_t i = 0; i < res->order.size(); i++) fprintf(out, ",%" PRIu64, res->order[i]);
+    fprintf(out, "\n%" PRIu64 "\n", res->totalTracks);
+    fprintf(out, "service(ms): total=%.3f mean=%.3f\n", service, reqs.empty() ? 0.0 : service / reqs.size());
+    fprintf(out, "latency(ms): mean=%.3f p50=%.3f p90=%.3f p99=%.3f max=%.3f\n",
+            reqs.empty() ? 0.0 : sum / reqs.size(), percentile(latency, 0.5), percentile(latency, 0.9),
+            percentile(latency, 0.99), latency.empty() ? 0.0 : latency.back());
+    fprintf(out, "starvation(ms): max=%.3f\n", wait.empty() ? 0.0 : wait.back());
+    // 请求带有读写标记或进程号时，分别输出读/写以及各进程的尾时延
+    vector<double> byDir[2];
+    map<int, vector<double> > byPid;
+    for (size_t i = 0; i < reqs.size(); i++) {
+        byDir[reqs[i].write].push_back(reqs[i].finish - reqs[i].arrival);
+        byPid[reqs[i].pid].push_back(reqs[i].finish - reqs[i].arrival);
+    }
+    if (!byDir[1].empty()) {
+        for (int dir = 0; dir < 2; dir++) {
+            sort(byDir[dir].begin(), byDir[dir].end());
+            fprintf(out, "%s latency(ms): requests=%zu p99=%.3f max=%.3f\n", dir ? "write" : "read", byDir[dir].size(),
+                    percentile(byDir[dir], 0.99), byDir[dir].empty() ? 0.0 : byDir[dir].back());
+        }
+    }
+    if (byPid.size() > 1) {
+        for (auto p = byPid.begin(); p != byPid.end(); ++p) {
+            sort(p->second.begin(), p->second.end());
+            fprintf(out, "pid %d latency(ms): requests=%zu p99=%.3f max=%.3f\n", p->first, p->second.size(),
+                    percentile(p->second, 0.99), p->second.back());
+        }
+    }
+}
+// 读取一个 "磁道[:扇区][/到达时刻[/R|W[/进程号]]]" 请求，返回是否读到请求，*last 表示序列是否结束，
+// 磁道号为负数时置 *invalid
+static bool readTimedTask(dTimedTask* req, bool* last, bool* invalid) {
+    int tmpChar;
+    req->sector = 0;
+    req->arrival = 0.0;
+    req->write = false;
+    req->pid = 0;
+    if (!readTrack(&req->track, invalid)) return false;
+    tmpChar = getchar();
+    if (tmpChar == ':') {
+        if (scanf("%d", &req->sector) != 1) return false;
+        tmpChar = getchar();
+    }
+    if (tmpChar == '/') {
+        if (scanf("%lf", &req->arrival) != 1) return false;
+        tmpChar = getchar();
+    }
+    if (tmpChar == '/') {
+        tmpChar = getchar();
+        req->write = (tmpChar == 'W' || tmpChar == 'w');
+        tmpChar = getchar();
+    }
+    if (tmpChar == '/') {
+        if (scanf("%d", &req->pid) != 1) return false;
+        tmpChar = getchar();
     }
-    // 填写分隔符右边的任务
-    for (int i = taskNum - 1; i >= tag; i--) {
-        sTable[sTag+1] = tasks[i].track;
-        tasks[i].state = FINISHED;
-        totalTracks += getDistance(sTable[sTag], tasks[i].track);
-        sTag++;
+    *last = (tmpChar == '\n' || tmpChar == EOF);
+    return true;
+}
+// 按时间模拟的入口：在线模式读取到达时刻；否则所有请求在 0 时刻到达（SPTF 与旋转模型）
+static int runOnline(const onlineConfig* base, bool online, const char* tracePath, FILE* out) {
+    vector<dTimedTask> reqs;
+    dTimedTask req = {0, 0, 0, 0, -1, 0, false, 0.0, 0.0, 0.0};
+    onlineConfig cfg = *base;
+    onlineResult res;
+    bool last = false, invalid = false;
+    if (cfg.algNum < _FCFS || cfg.algNum > _BFQ) {
+        fprintf(out, "Unrecognized Algorithm.");
+        return EXIT_FAILURE;
+    }
+    if (tracePath != nullptr) {
+        traceReader trace;
+        int64_t track;
+        if (!traceOpen(&trace, tracePath, TRACE_TRACKS)) {
+            fprintf(out, "Invalid trace file.");
+            return EXIT_FAILURE;
+        }
+        while (traceNext(&trace, &track) && !invalid) {
+            invalid = track < 0;
+            req.track = (uint64_t)track;
+            reqs.push_back(req);
+        }
+        bool complete = trace.remaining == 0;
+        traceClose(&trace);
+        if (invalid) {
+            fprintf(out, "Invalid track number.");
+            return EXIT_FAILURE;
+        }
+        if (!complete) {
+            fprintf(out, "Truncated trace file.");
+            return EXIT_FAILURE;
+        }
+    } else {
+        while (!last && readTimedTask(&req, &last, &invalid)) {
+            if (!online) req.arrival = 0.0;
+            reqs.push_back(req);
+        }
+        if (invalid) {
+            fprintf(out, "Invalid track number.");
+            return EXIT_FAILURE;
+        }
+    }
+    for (size_t i = 0; i < reqs.size(); i++) {
+        if (cfg.diskSize > 0 && reqs[i].track >= cfg.diskSize) {
+            fprintf(out, "Track out of range.");
+            return EXIT_FAILURE;
+        }
+    }
+    onlineSchedule(reqs, &cfg, &res);
+    onlineOutput(reqs, &cfg, &res, out);
+    return 0;
+}
+struct blkRequest {                                         // 导入中的块请求
+    uint64_t start;                                         // 起始扇区
+    uint64_t size;                                          // 扇区数
+    double arrival;                                         // 到达时刻(ms)
+    int pid;                                                // 发出请求的进程
+    bool write;                                             // 是否为写请求
+};
+// 读取 blkparse 记录并合并相邻请求，返回读到的事件数
+static size_t importBlkparse(FILE* in, const blkImport* imp, vector<blkRequest>* out,
+                             size_t* backMerges, size_t* frontMerges) {
+    char line[1024];
+    char action[16], rwbs[16];
+    double seconds, first = -1;
+    uint64_t sector, size;
+    int pid;
+    size_t events = 0;
+    unordered_map<uint64_t, size_t> byEnd, byStart;         // 合并窗口内请求的结束/起始扇区 -> 下标
+    deque<size_t> recent;                                   // 合并窗口内的请求，按到达次序
+    while (fgets(line, sizeof(line), in) != nullptr) {
+        if (sscanf(line, "%*s %*s %*s %lf %d %15s %15s %" SCNu64 " + %" SCNu64,
+                   &seconds, &pid, action, rwbs, &sector, &size) != 6) continue;
+        if (action[0] != imp->action || action[1] != '\0' || size == 0) continue;
+        bool write = strchr(rwbs, 'W') != nullptr;
+        if (!write && strchr(rwbs, 'R') == nullptr) continue;
+        events++;
+        if (first < 0) first = seconds;
+        double arrival = (seconds - first) * 1000.0;
+        vector<blkRequest>& reqs = *out;
+        // 1. 淘汰超出合并窗口的请求
+        while (!recent.empty() && arrival - reqs[recent.front()].arrival > imp->mergeWindow) {
+            size_t old = recent.front();
+            recent.pop_front();
+            auto e = byEnd.find(reqs[old].start + reqs[old].size);
+            if (e != byEnd.end() && e->second == old) byEnd.erase(e);
+            auto s = byStart.find(reqs[old].start);
+            if (s != byStart.end() && s->second == old) byStart.erase(s);
+        }
+        // 2. 后向合并：接在某个请求之后
+        if (imp->mergeWindow > 0) {
+            auto e = byEnd.find(sector);
+            if (e != byEnd.end()) {
+                blkRequest& r = reqs[e->second];
+                if (r.write == write && r.size + size <= MAX_MERGE_SECTORS) {
+                    size_t k = e->second;
+                    byEnd.erase(e);
+                    r.size += size;
+                    byEnd[r.start + r.size] = k;
+                    (*backMerges)++;
+                    continue;
+                }
+            }
+            // 3. 前向合并：接在某个请求之前
+            auto s = byStart.find(sector + size);
+            if (s != byStart.end()) {
+                blkRequest& r = reqs[s->second];
+                if (r.write == write && r.size + size <= MAX_MERGE_SECTORS) {
+                    size_t k = s->second;
+                    byStart.erase(s);
+                    r.start = sector;
+                    r.size += size;
+                    byStart[r.start] = k;
+                    (*frontMerges)++;
+                    continue;
+                }
+            }
+        }
+        // 4. 不能合并：作为新请求
+        blkRequest req = {sector, size, arrival, pid, write};
+        reqs.push_back(req);
+        if (imp->mergeWindow > 0) {
+            byEnd[sector + size] = reqs.size() - 1;
+            byStart[sector] = reqs.size() - 1;
+            recent.push_back(reqs.size() - 1);
+        }
     }
+    return events;
+}
+// 导入块设备访问记录并按时间模拟；在线模式使用记录中的时刻，否则所有请求在 0 时刻到达
+static int runImport(const onlineConfig* base, bool online, const blkImport* imp, FILE* out) {
+    vector<blkRequest> blk;
+    vector<dTimedTask> reqs;
+    onlineConfig cfg = *base;
+    const diskModel* model = &cfg.model;
+    onlineResult res;
+    size_t backMerges = 0, frontMerges = 0;
+    if (cfg.algNum < _FCFS || cfg.algNum > _BFQ) {
+        fprintf(out, "Unrecognized Algorithm.");
+        return EXIT_FAILURE;
+    }
+    FILE* in = strcmp(imp->path, "-") == 0 ? stdin : fopen(imp->path, "r");
+    if (in == nullptr) {
+        fprintf(out, "Cannot open %s.", imp->path);
+        return EXIT_FAILURE;
+    }
+    size_t events = importBlkparse(in, imp, &blk, &backMerges, &frontMerges);
+    if (in != stdin) fclose(in);
+    // 扇区 -> (柱面, 扇区)
+    uint64_t perCylinder = (uint64_t)model->sectorsPerTrack * imp->heads;
+    reqs.reserve(blk.size());
+    for (size_t i = 0; i < blk.size(); i++) {
+        dTimedTask req = {blk[i].start / perCylinder, (int)(blk[i].start % model->sectorsPerTrack),
+                          (int)blk[i].size, (int)i, -1, blk[i].pid, blk[i].write, online ? blk[i].arrival : 0.0, 0.0, 0.0};
+        if (cfg.diskSize > 0 && req.track >= cfg.diskSize) {
+            fprintf(out, "Track out of range.");
+            return EXIT_FAILURE;
+        }
+        reqs.push_back(req);
+    }
+    onlineSchedule(reqs, &cfg, &res);
+    onlineOutput(reqs, &cfg, &res, out);
+    fprintf(out, "import: events=%zu requests=%zu merges: back=%zu front=%zu\n", events, reqs.size(), backMerges, frontMerges);
+    return 0;
+}
+static void addPhysical(vector<vector<dTimedTask> >& perDisk, const diskModel* model, int disk,
+                        long long block, int blocks, bool write, double arrival, int owner, int rmw = -1) {
+    dTimedTask req = {(uint64_t)block / model->sectorsPerTrack, (int)(block % model->sectorsPerTrack),
+                      blocks, owner, rmw, 0, write, arrival, 0.0, 0.0};
+    perDisk[disk].push_back(req);
+}
+// RAID-5：逐行拆分一个逻辑请求，部分行写分配一个读-改-写组，返回下一个组号
+static int mapParity(const raidLayout* layout, const diskModel* model, const raidRequest& req, int owner,
+                     int group, vector<vector<dTimedTask> >& perDisk) {
+    int dataDisks = layout->disks - 1;
+    long long rowBlocks = (long long)layout->stripe * dataDisks;
+    long long block = req.lba;
+    long long end = req.lba + req.blocks;
+    while (block < end) {
+        long long row = block / rowBlocks;                              // 条带行
+        long long rowEnd = min(end, (row + 1) * rowBlocks);
+        int parity = (int)(layout->disks - 1 - row % layout->disks);
+        bool full = block == row * rowBlocks && rowEnd == (row + 1) * rowBlocks;
+        int rmw = req.write && !full ? group++ : -1;
+        int low = layout->stripe, high = 0;                             // 校验条带单元内的读写范围
+        for (long long b = block; b < rowEnd; ) {
+            long long unit = b / layout->stripe;                        // 逻辑条带号
+            int offset = (int)(b % layout->stripe);
+            int len = (int)min<long long>(layout->stripe - offset, rowEnd - b);
+            int disk = (int)(unit % dataDisks);
+            if (disk >= parity) disk++;
+            long long pb = row * layout->stripe + offset;               // 磁盘内物理块
+            if (!req.write || rmw >= 0) addPhysical(perDisk, model, disk, pb, len, false, req.arrival, owner, rmw);
+            if (req.write) addPhysical(perDisk, model, disk, pb, len, true, req.arrival, owner, rmw);
+            low = min(low, offset);
+            high = max(high, offset + len);
+            b += len;
+        }
+        if (req.write) {
+            long long pb = row * layout->stripe + low;
+            if (rmw >= 0) addPhysical(perDisk, model, parity, pb, high - low, false, req.arrival, owner, rmw);
+            addPhysical(perDisk, model, parity, pb, high - low, true, req.arrival, owner, rmw);
+        }
+        block = rowEnd;
+    }
+    return group;
+}
+// 将逻辑请求映射为各磁盘上的物理请求（RAID-0/5 按条带单元拆分），返回读-改-写组数
+int raidMap(const raidLayout* layout, const diskModel* model, const vector<raidRequest>& reqs,
+            vector<vector<dTimedTask> >& perDisk) {
+    int groups = 0;
+    for (size_t r = 0; r < reqs.size(); r++) {
+        if (layout->level == 5) {
+            groups = mapParity(layout, model, reqs[r], (int)r, groups, perDisk);
+            continue;
+        }
+        if (layout->level == 1) {
+            // 镜像盘上的位置与逻辑块相同，一个逻辑请求在每块涉及的磁盘上只发出一个物理请求
+            if (!reqs[r].write) {
+                addPhysical(perDisk, model, (int)(r % layout->disks), reqs[r].lba, reqs[r].blocks, false,
+                            reqs[r].arrival, (int)r);
+            } else {
+                for (int d = 0; d < layout->disks; d++)
+                    addPhysical(perDisk, model, d, reqs[r].lba, reqs[r].blocks, true, reqs[r].arrival, (int)r);
+            }
+            continue;
+        }
+        long long block = reqs[r].lba;
+        long long end = reqs[r].lba + reqs[r].blocks;
+        while (block < end) {
+            long long unit = block / layout->stripe;                    // 逻辑条带号
+            int offset = (int)(block % layout->stripe);
+            int len = (int)min<long long>(layout->stripe - offset, end - block);
+            long long row = unit / layout->disks;                       // 条带行
+            long long pb = row * layout->stripe + offset;               // 磁盘内物理块
+            addPhysical(perDisk, model, (int)(unit % layout->disks), pb, len, reqs[r].write, reqs[r].arrival, (int)r);
+            block += len;
+        }
+    }
+    return groups;
+}
+// 读取 "逻辑块[+块数][/到达时刻][/R|W]" 序列
+static bool readRaidRequests(vector<raidRequest>* reqs, FILE* out) {
+    char token[256];
+    int len = 0;
+    int c;
+    // 跳过首行剩余的空白
+    while ((c = getchar()) == '\n' || c == ' ' || c == '\r') {}
+    ungetc(c, stdin);
+    do {
+        c = getchar();
+        if (c == ',' || c == '\n' || c == ' ' || c == '\r' || c == EOF) {
+            if (len > 0) {
+                raidRequest req = {0, 1, 0.0, false, 0.0};
+                char* p;
+                token[len] = '\0';
+                req.lba = strtoll(token, &p, 10);
+                if (*p == '+') req.blocks = (int)strtol(p + 1, &p, 10);
+                if (*p == '/') req.arrival = strtod(p + 1, &p);
+                if (*p == '/') req.write = (p[1] == 'W' || p[1] == 'w');
+                if (req.lba < 0 || req.blocks < 1) {
+                    fprintf(out, "Invalid request %s.", token);
+                    return false;
+                }
+                reqs->push_back(req);
+            }
+            len = 0;
+        } else if (len < (int)sizeof(token) - 1) {
+            token[len++] = (char)c;
+        }
+    } while (c != '\n' && c != EOF);
+    return true;
+}
+static int runRaid(const onlineConfig* base, const raidLayout* layout, FILE* out) {
+    vector<raidRequest> reqs;
+    vector<vector<dTimedTask> > mapped(layout->disks), perDisk(layout->disks);
+    vector<onlineResult> results(layout->disks);
+    vector<thread> workers;
+    onlineConfig cfg = *base;
+    if (cfg.algNum < _FCFS || cfg.algNum > _BFQ) {
+        fprintf(out, "Unrecognized Algorithm.");
+        return EXIT_FAILURE;
+    }
+    // 1. 读取逻辑请求并映射到各磁盘
+    if (!readRaidRequests(&reqs, out)) return EXIT_FAILURE;
+    int groups = raidMap(layout, &cfg.model, reqs, mapped);
+    // 2. 每块磁盘一个线程，独立调度。第一轮不调度读-改-写组内的写；之后每轮把这些写在组内
+    //    读的完成时刻释放，直到没有写早于其读的完成时刻到达
+    vector<double> release(groups, -1.0);                       // 组内写的到达时刻，-1 表示尚未释放
+    for (int round = 0; ; round++) {
+        if (round == RAID_MAX_ROUNDS) {
+            fprintf(out, "RAID schedule does not converge.");
+            return EXIT_FAILURE;
+        }
+        for (int d = 0; d < layout->disks; d++) {
+            perDisk[d].clear();
+            for (size_t i = 0; i < mapped[d].size(); i++) {
+                dTimedTask req = mapped[d][i];
+                if (req.write && req.rmw >= 0) {
+                    if (release[req.rmw] < 0) continue;
+                    req.arrival = release[req.rmw];
+                }
+                perDisk[d].push_back(req);
+            }
+        }
+        workers.clear();
+        for (int d = 0; d < layout->disks; d++) {
+            workers.push_back(thread([&, d] () { onlineSchedule(perDisk[d], &cfg, &results[d]); }));
+        }
+        for (size_t d = 0; d < workers.size(); d++) workers[d].join();
+        vector<double> readDone(groups, 0.0);
+        for (int d = 0; d < layout->disks; d++) {
+            for (size_t i = 0; i < perDisk[d].size(); i++) {
+                const dTimedTask& req = perDisk[d][i];
+                if (!req.write && req.rmw >= 0) readDone[req.rmw] = max(readDone[req.rmw], req.finish);
+            }
+        }
+        bool settled = true;
+        for (int g = 0; g < groups; g++) {
+            if (release[g] < readDone[g]) {
+                release[g] = readDone[g];
+                settled = false;
+            }
+        }
+        if (settled) break;
+    }
+    // 3. 汇总：逻辑请求在最后一个物理请求完成时完成
+    for (size_t r = 0; r < reqs.size(); r++) reqs[r].finish = reqs[r].arrival;
+    for (int d = 0; d < layout->disks; d++) {
+        for (size_t i = 0; i < perDisk[d].size(); i++) {
+            raidRequest& owner = reqs[perDisk[d][i].owner];
+            owner.finish = max(owner.finish, perDisk[d][i].finish);
+        }
+    }
+    // 4. 输出各磁盘寻道数、队列深度分布和阵列请求时延
+    size_t physical = 0;
+    for (int d = 0; d < layout->disks; d++) {
+        const vector<long long>& hist = results[d].depthHist;
+        long long dispatches = 0, sum = 0, seen = 0;
+        int p50 = 0, p99 = 0;
+        for (size_t k = 0; k < hist.size(); k++) {
+            dispatches += hist[k];
+            sum += hist[k] * (long long)k;
+        }
+        for (size_t k = 0; k < hist.size(); k++) {
+            if (seen < (dispatches + 1) / 2 && seen + hist[k] >= (dispatches + 1) / 2) p50 = (int)k;
+            if (seen < (long long)ceil(dispatches * 0.99) && seen + hist[k] >= (long long)ceil(dispatches * 0.99)) p99 = (int)k;
+            seen += hist[k];
+        }
+        physical += perDisk[d].size();
+        fprintf(out, "disk %d: requests=%zu tracks=%" PRIu64 " depth: mean=%.3f p50=%d p99=%d max=%d\n", d, perDisk[d].size(),
+                results[d].totalTracks, dispatches > 0 ? (double)sum / dispatches : 0.0, p50, p99,
+                hist.empty() ? 0 : (int)hist.size() - 1);
+    }
+    vector<double> latency;
+    double total = 0;
+    for (size_t r = 0; r < reqs.size(); r++) {
+        latency.push_back(reqs[r].finish - reqs[r].arrival);
+        total += latency.back();
+    }
+    sort(latency.begin(), latency.end());
+    fprintf(out, "array: requests=%zu physical=%zu\n", reqs.size(), physical);
+    fprintf(out, "latency(ms): mean=%.3f p50=%.3f p90=%.3f p99=%.3f max=%.3f\n",
+            reqs.empty() ? 0.0 : total / reqs.size(), percentile(latency, 0.5), percentile(latency, 0.9),
+            percentile(latency, 0.99), latency.empty() ? 0.0 : latency.back());
+    return 0;
 }
 // 输出函数
-void output() {
-    for (int i = 0; i < taskNum; i++) {
-        printf("%d,", sTable[i]);
+void DiskScheduler::output() {
+    fprintf(out, "%" PRIu64, position);
+    for (size_t i = 0; i < taskNum; i++) {
+        fprintf(out, ",%" PRIu64, tasks[i]);
     }
-    printf("%d\n", sTable[taskNum]);
-    printf("%d\n", totalTracks);
+    fprintf(out, "\n");
+    fprintf(out, "%" PRIu64 "\n", totalTracks);
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+/* Memory Dynamic Partition Engine */
+#ifndef MEM_PARTITION_H
+#define MEM_PARTITION_H
+
+#include <cstdio>
+
+// MState 内存块的状态
+enum MState {UNUSED, USED};
+// Memory 内存块结构体
+struct Memory {
+    int startAddr;          // 起始地址
+    int endAddr;            // 结束地址
+    int size;               // 内存块大小
+    int pid;                // 进程ID
+    MState state;           // 内存块状态
+    struct Memory *next;    // 下一个内存块
+};
+// ReqList 请求列表
+struct Request {
+    int sn;         // serial number
+    int pid;        // process id
+    int op;         // operation
+    int opVol;      // volume of operation
+};
+// pFunc 函数指针：用于不同的内存分配算法
+typedef void (*pFunc)(Request request, Memory *mem);
+// FF 分配函数
+void FFalloc(Request request, Memory *mem);
+// BF 分配函数
+void BFalloc(Request request, Memory *mem);
+// WF 分配函数
+void WFalloc(Request request, Memory *mem);
+// 内存释放函数
+void memFree(Request request, Memory *mem);
+
+/*
+ * 动态分区分配器:
+ *  内存块链表属于实例而不是全局变量，多个分配器可以在同一进程中同时运行。
+ *  每处理一个请求后可调用 output 按 "序号/起始-结束.状态[.进程]" 格式输出当前内存布局。
+ */
+class PartitionAllocator {
+public:
+    explicit PartitionAllocator(int memSize, FILE *out = stdout);
+    ~PartitionAllocator();
+    bool select(int algNum);                // 算法选择，未知算法返回 false
+    bool apply(Request request);            // 执行请求，无效操作返回 false
+    void output(Request request);           // 结果输出函数
+
+    Memory *memory;                         // 内存块链表
+
+private:
+    PartitionAllocator(const PartitionAllocator&);
+    PartitionAllocator& operator=(const PartitionAllocator&);
+
+    pFunc pAlloc;                           // 当前分配算法
+    FILE *out;                              // 输出流
+};
+
+#endif
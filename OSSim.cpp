@@ -0,0 +1,44 @@
+/* OS Simulation Driver */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "OSSim.h"
+
+using namespace std;
+
+/*
+ * 驱动程序: ossim <子命令> [参数...]
+ *  子命令之后的参数原样交给对应实验的入口，标准输入/输出格式与原实验程序相同。
+ */
+typedef int (*pMainFunc)(int argc, char* argv[]);
+struct subCommand {
+    const char* name;                                       // 子命令
+    pMainFunc entry;                                        // 实验入口
+    const char* help;                                       // 说明
+};
+static const subCommand commands[] = {
+    {"sched", procSchedMain, "进程调度（实验1）"},
+    {"partition", memPartitionMain, "动态分区分配（实验2）"},
+    {"paging", pagedMemMain, "分页存储管理（实验3）"},
+    {"disk", diskScheduleMain, "磁盘调度（实验5）"},
+    {"convert", traceConvertMain, "访问序列格式转换"},
+};
+
+int main(int argc, char* argv[])
+{
+    char name[256];
+    if (argc >= 2) {
+        for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+            if (strcmp(argv[1], commands[i].name) != 0) continue;
+            // 子命令的 argv[0] 为 "ossim <子命令>"，用于各实验的用法提示
+            snprintf(name, sizeof(name), "%s %s", argv[0], argv[1]);
+            argv[1] = name;
+            return commands[i].entry(argc - 1, argv + 1);
+        }
+    }
+    printf("Usage: %s <command> [args...]\n", argv[0]);
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        printf("    %-10s %s\n", commands[i].name, commands[i].help);
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,26 @@
+/* OS Simulation Library */
+#ifndef OSSIM_H
+#define OSSIM_H
+
+/*
+ * ossim 静态库:
+ *  各实验的算法实现为可重入的引擎类，状态全部保存在实例中：
+ *      ProcScheduler       进程调度（实验1）
+ *      PartitionAllocator  动态分区分配（实验2）
+ *      PagedMemory         分页存储管理（实验3）
+ *      DiskScheduler       磁盘调度（实验5），onlineSchedule 为按时间模拟的在线调度
+ *  xxxMain 为各实验的命令行入口，读写格式与原实验程序相同，由 ossim 驱动程序按子命令调用。
+ */
+#include "ProcSched.h"
+#include "MemPartition.h"
+#include "PagedMem.h"
+#include "DiskSched.h"
+#include "TraceFormat.h"
+
+int procSchedMain(int argc, char* argv[]);
+int memPartitionMain(int argc, char* argv[]);
+int pagedMemMain(int argc, char* argv[]);
+int diskScheduleMain(int argc, char* argv[]);
+int traceConvertMain(int argc, char* argv[]);
+
+#endif
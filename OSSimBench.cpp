@@ -0,0 +1,245 @@
+/* OS Simulation Benchmarks */
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "OSSim.h"
+
+using namespace std;
+
+/*
+ * 各实验算法的基准测试:
+ *  输入规模 n 从 10 到 BENCH_MAX_N 按 10 倍递增，输入由固定种子的生成器产生，生成不计入计时。
+ *  每个测试报告 time_per_op（每个进程/请求/访问的平均耗时，JSON 中单位为秒）、items_per_second，
+ *  并按 n 拟合渐进复杂度（BigO/RMS）。--benchmark_out=file.json --benchmark_out_format=json 输出 JSON，
+ *  可用 benchmark 自带的 compare.py 比较两次结果。
+ *  O(n^2) 的算法（SJF、SRTF、RR、DPSA 逐个时刻扫描 PCB 表，SPTF 每次扫描整个队列）只测到
+ *  QUADRATIC_MAX_N。OPT 的计时包括建立下次访问索引。
+ */
+#ifndef BENCH_MAX_N
+#define BENCH_MAX_N 10000000
+#endif
+#define QUADRATIC_MAX_N (BENCH_MAX_N < 10000 ? BENCH_MAX_N : 10000)
+#define ONLINE_MAX_N (BENCH_MAX_N < 1000000 ? BENCH_MAX_N : 1000000)
+#define BENCH_SEED 20240601                                 // 生成器种子
+#define BENCH_MEM_SIZE 65535                                // 动态分区内存大小
+#define BENCH_LIVE_PROCS 256                                // 动态分区最多同时驻留的进程数
+#define BENCH_FRAMES 16                                     // 驻留集页面数
+#define BENCH_HOT_PAGES 32                                  // 热点页面数
+#define BENCH_COLD_PAGES 96                                 // 非热点页面数
+#define BENCH_DISK_SIZE 65536                               // 批处理磁盘柱面数
+#define BENCH_ONLINE_TRACKS 1000                            // 在线调度磁道范围
+
+// 调度结果写入 /dev/null，输出开销与实验程序相同
+static FILE* nullOutput()
+{
+    static FILE* out = fopen("/dev/null", "w");
+    return out;
+}
+// 设置复杂度规模和吞吐量计数器
+static void setRates(benchmark::State& state, int64_t n)
+{
+    double ops = (double)state.iterations() * (double)n;
+    state.SetComplexityN(n);
+    state.SetItemsProcessed((int64_t)ops);
+    state.counters["time_per_op"] = benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// 进程：到达间隔 0~4，运行时间 1~16，优先级 1~10，时间片 4
+static vector<task_struct> genProcs(int n)
+{
+    mt19937 rng(BENCH_SEED);
+    ProcScheduler gen(nullOutput());
+    int arrival = 0;
+    gen.pcb_table.reserve(n);
+    for (int i = 0; i < n; i++) {
+        arrival += (int)(rng() % 5);
+        gen.add(i, arrival, 1 + (int)(rng() % 16), 1 + (int)(rng() % 10), 4);
+    }
+    return gen.pcb_table;
+}
+/*
+ * 分区请求：随机分配 1~1024 或释放一个驻留进程。释放不存在的进程在实验程序中是非法输入，
+ * 因此生成时用同一算法的分配器模拟，分配失败的请求直接丢弃，保证回放时每个释放都有效。
+ */
+static vector<Request> genRequests(int n, int algNum)
+{
+    mt19937 rng(BENCH_SEED);
+    vector<Request> reqs;
+    vector<int> live;
+    PartitionAllocator allocator(BENCH_MEM_SIZE, nullOutput());
+    int pid = 0;
+    allocator.select(algNum);
+    while ((int)reqs.size() < n) {
+        Request request = {(int)reqs.size(), 0, 1, 0};
+        if (live.empty() || (live.size() < BENCH_LIVE_PROCS && rng() % 2 == 0)) {
+            request.pid = pid++;
+            request.opVol = 1 + (int)(rng() % 1024);
+            allocator.apply(request);
+            bool placed = false;
+            for (Memory* mem = allocator.memory; mem != nullptr && !placed; mem = mem->next) {
+                placed = mem->state == USED && mem->pid == request.pid;
+            }
+            if (!placed) continue;
+            live.push_back(request.pid);
+        } else {
+            size_t k = rng() % live.size();
+            request.pid = live[k];
+            request.op = 2;
+            live[k] = live.back();
+            live.pop_back();
+            allocator.apply(request);
+        }
+        reqs.push_back(request);
+    }
+    return reqs;
+}
+// 页面访问：80% 落在热点页面，其余均匀落在非热点页面
+static vector<int> genPages(int n)
+{
+    mt19937 rng(BENCH_SEED);
+    vector<int> pages(n);
+    for (int i = 0; i < n; i++) {
+        if (rng() % 5 != 0) pages[i] = (int)(rng() % BENCH_HOT_PAGES);
+        else pages[i] = BENCH_HOT_PAGES + (int)(rng() % BENCH_COLD_PAGES);
+    }
+    return pages;
+}
+// 批处理磁道请求：均匀分布在整个磁盘上
+static vector<uint64_t> genTracks(int n)
+{
+    mt19937_64 rng(BENCH_SEED);
+    vector<uint64_t> tracks(n);
+    for (int i = 0; i < n; i++) tracks[i] = rng() % BENCH_DISK_SIZE;
+    return tracks;
+}
+// 在线请求：平均间隔 5ms，30% 为写请求，来自 4 个进程
+static vector<dTimedTask> genTimedTasks(int n)
+{
+    mt19937 rng(BENCH_SEED);
+    exponential_distribution<double> gap(1.0 / 5.0);
+    vector<dTimedTask> reqs(n);
+    double clock = 0.0;
+    for (int i = 0; i < n; i++) {
+        clock += gap(rng);
+        dTimedTask req = {rng() % BENCH_ONLINE_TRACKS, (int)(rng() % 500), 8, 0, -1, 1 + (int)(rng() % 4),
+                          rng() % 10 < 3, clock, 0.0, 0.0};
+        reqs[i] = req;
+    }
+    return reqs;
+}
+
+// 实验1：进程调度，每次迭代调度 n 个进程
+static void BM_ProcSched(benchmark::State& state, int algNum)
+{
+    int n = (int)state.range(0);
+    vector<task_struct> procs = genProcs(n);
+    for (auto _ : state) {
+        ProcScheduler sched(nullOutput());
+        sched.pcb_table = procs;
+        sched.pcb_cnt = n;
+        sched.run(algNum);
+        benchmark::DoNotOptimize(sched.pcb_table.data());
+    }
+    setRates(state, n);
+}
+// 实验2：动态分区，每次迭代执行 n 个分配/释放请求
+static void BM_MemPartition(benchmark::State& state, int algNum)
+{
+    int n = (int)state.range(0);
+    vector<Request> reqs = genRequests(n, algNum);
+    for (auto _ : state) {
+        PartitionAllocator allocator(BENCH_MEM_SIZE, nullOutput());
+        allocator.select(algNum);
+        for (size_t i = 0; i < reqs.size(); i++) allocator.apply(reqs[i]);
+        benchmark::DoNotOptimize(allocator.memory);
+    }
+    setRates(state, n);
+}
+// 实验3：页面置换，每次迭代模拟 n 次访问
+static void BM_PagedMem(benchmark::State& state, int algNum)
+{
+    int n = (int)state.range(0);
+    vector<int> pages = genPages(n);
+    vector<uint32_t> nextDist;
+    for (auto _ : state) {
+        PagedMemory mem;
+        refStream refs;
+        int currPage;
+        mem.init(algNum, BENCH_FRAMES);
+        if (mem.policy.lookahead) {
+            nextDist.resize(pages.size());
+            buildNextUse(pages.data(), (long)pages.size(), nextDist.data());
+        }
+        refInitMem(&refs, pages.data(), (long)pages.size(), mem.policy.lookahead ? nextDist.data() : nullptr);
+        while (refNext(&refs, &currPage)) mem.access(currPage, &refs);
+        refFree(&refs);
+        benchmark::DoNotOptimize(mem.missTimes);
+    }
+    setRates(state, n);
+}
+// 实验5：批处理磁盘调度，每次迭代排出 n 个请求的服务顺序
+static void BM_DiskSched(benchmark::State& state, int algNum)
+{
+    int n = (int)state.range(0);
+    vector<uint64_t> tracks = genTracks(n);
+    for (auto _ : state) {
+        DiskScheduler sched(nullOutput());
+        sched.diskSize = BENCH_DISK_SIZE;
+        sched.tasks = tracks;
+        sched.run(algNum, BENCH_DISK_SIZE / 2, 1);
+        benchmark::DoNotOptimize(sched.totalTracks);
+    }
+    setRates(state, n);
+}
+// 实验5：在线磁盘调度，每次迭代按到达时刻模拟 n 个请求
+static void BM_OnlineDiskSched(benchmark::State& state, int algNum)
+{
+    int n = (int)state.range(0);
+    vector<dTimedTask> reqs = genTimedTasks(n);
+    diskModel model = {linearSeek, 1.0, 0.01, 0.1, 400, 0.0, 500, 1};
+    onlineConfig cfg = {algNum, BENCH_ONLINE_TRACKS / 2, 1, BENCH_ONLINE_TRACKS, 10, 500.0, 5000.0, 256,
+                        model, nullptr, nullptr, nullptr};
+    for (auto _ : state) {
+        vector<dTimedTask> run = reqs;
+        onlineResult res;
+        onlineSchedule(run, &cfg, &res);
+        benchmark::DoNotOptimize(res.totalTracks);
+    }
+    setRates(state, n);
+}
+
+#define BENCH_RANGE(maxN) RangeMultiplier(10)->Range(10, maxN)->Complexity()
+
+BENCHMARK_CAPTURE(BM_ProcSched, FCFS, 1)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_ProcSched, SJF, 2)->BENCH_RANGE(QUADRATIC_MAX_N);
+BENCHMARK_CAPTURE(BM_ProcSched, SRTF, 3)->BENCH_RANGE(QUADRATIC_MAX_N);
+BENCHMARK_CAPTURE(BM_ProcSched, RR, 4)->BENCH_RANGE(QUADRATIC_MAX_N);
+BENCHMARK_CAPTURE(BM_ProcSched, DPSA, 5)->BENCH_RANGE(QUADRATIC_MAX_N);
+
+BENCHMARK_CAPTURE(BM_MemPartition, FF, 1)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_MemPartition, BF, 2)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_MemPartition, WF, 3)->BENCH_RANGE(BENCH_MAX_N);
+
+BENCHMARK_CAPTURE(BM_PagedMem, OPT, OPT)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_PagedMem, FIFO, FIFO)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_PagedMem, LRU, LRU)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_PagedMem, CLOCK, CLOCK)->BENCH_RANGE(BENCH_MAX_N);
+
+BENCHMARK_CAPTURE(BM_DiskSched, FCFS, _FCFS)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, SSTF, _SSTF)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, SCAN, _SCAN)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, CSCAN, _CSCAN)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, LOOK, _LOOK)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, CLOOK, _CLOOK)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, NSCAN, _NSCAN)->BENCH_RANGE(BENCH_MAX_N);
+BENCHMARK_CAPTURE(BM_DiskSched, FSCAN, _FSCAN)->BENCH_RANGE(BENCH_MAX_N);
+
+BENCHMARK_CAPTURE(BM_OnlineDiskSched, SSTF, _SSTF)->BENCH_RANGE(ONLINE_MAX_N);
+BENCHMARK_CAPTURE(BM_OnlineDiskSched, SCAN, _SCAN)->BENCH_RANGE(ONLINE_MAX_N);
+BENCHMARK_CAPTURE(BM_OnlineDiskSched, SPTF, _SPTF)->BENCH_RANGE(QUADRATIC_MAX_N);
+BENCHMARK_CAPTURE(BM_OnlineDiskSched, DEADLINE, _DEADLINE)->BENCH_RANGE(ONLINE_MAX_N);
+BENCHMARK_CAPTURE(BM_OnlineDiskSched, BFQ, _BFQ)->BENCH_RANGE(ONLINE_MAX_N);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,151 @@
+/* OS Simulation Differential Tests */
+#include <cstdio>
+#include <cstdlib>
+#include <cinttypes>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "OSSim.h"
+
+using namespace std;
+
+/*
+ * 差分测试: ossim-test [用例...]，不带参数时运行全部用例，由 ctest 调用
+ *  每个用例用固定种子生成一批随机输入，把引擎的结果与按定义直接写出的参考实现比较，
+ *  遇到第一处不一致时输出用例编号和输入参数并返回非 0。磁道范围很小，距离相同的情况很多。
+ *      sstf    DiskScheduler 的 SSTF 与逐个比较的 O(n^2) SSTF（原实验程序的写法）
+ *      online  所有请求在 0 时刻到达时，onlineSchedule 与批处理调度器的服务顺序和寻道数
+ *              （FCFS 到 FSCAN，指定/不指定磁盘大小，随机的 N 步扫描组大小）
+ */
+#define TEST_SEED 20240601                                  // 生成器种子
+#define TEST_CASES 1000                                     // 每个用例的随机输入数
+#define TEST_MAX_N 300                                      // 请求数上限
+#define TEST_TRACKS 200                                     // 磁道范围上限
+#define TEST_MAX_STEP 8                                     // N 步扫描法组大小上限
+
+typedef bool (*pTestFunc)();
+struct testCase {
+    const char* name;                                       // 用例名
+    pTestFunc run;                                          // 测试函数
+};
+
+// 调度结果写入 /dev/null
+static FILE* nullOutput()
+{
+    static FILE* out = fopen("/dev/null", "w");
+    return out;
+}
+// 随机请求序列：磁道范围 [0, tracks)
+static vector<uint64_t> genTracks(mt19937& rng, size_t n, uint64_t tracks)
+{
+    vector<uint64_t> result(n);
+    for (size_t i = 0; i < n; i++) result[i] = rng() % tracks;
+    return result;
+}
+static uint64_t getDistance(uint64_t x, uint64_t y)
+{
+    return x > y ? x - y : y - x;
+}
+// 参考 SSTF：每一步扫描所有未服务的请求，距离相同时选择输入次序靠前的请求
+static uint64_t refSSTF(const vector<uint64_t>& tracks, uint64_t position, vector<uint64_t>* order)
+{
+    vector<bool> finished(tracks.size(), false);
+    uint64_t head = position, total = 0;
+    order->clear();
+    for (size_t step = 0; step < tracks.size(); step++) {
+        size_t tag = tracks.size();
+        for (size_t j = 0; j < tracks.size(); j++) {
+            if (finished[j]) continue;
+            if (tag == tracks.size() || getDistance(head, tracks[j]) < getDistance(head, tracks[tag])) tag = j;
+        }
+        finished[tag] = true;
+        total += getDistance(head, tracks[tag]);
+        head = tracks[tag];
+        order->push_back(head);
+    }
+    return total;
+}
+static bool testSSTF()
+{
+    mt19937 rng(TEST_SEED);
+    vector<uint64_t> order;
+    for (int c = 0; c < TEST_CASES; c++) {
+        size_t n = rng() % (TEST_MAX_N + 1);
+        uint64_t tracks = 1 + rng() % TEST_TRACKS;
+        uint64_t position = rng() % tracks;
+        vector<uint64_t> reqs = genTracks(rng, n, tracks);
+        uint64_t total = refSSTF(reqs, position, &order);
+        DiskScheduler sched(nullOutput());
+        sched.tasks = reqs;
+        sched.run(_SSTF, position, 0);
+        if (sched.tasks != order || sched.totalTracks != total) {
+            printf("sstf: case %d differs (n=%zu tracks=%" PRIu64 " head=%" PRIu64 ")\n", c, n, tracks, position);
+            return false;
+        }
+    }
+    printf("sstf: %d cases passed\n", TEST_CASES);
+    return true;
+}
+static bool testOnline()
+{
+    mt19937 rng(TEST_SEED);
+    diskModel model = {linearSeek, 1.0, 0.01, 0.1, 400, 0.0, 500, 1};
+    for (int c = 0; c < TEST_CASES; c++) {
+        size_t n = rng() % (TEST_MAX_N + 1);
+        int algNum = _FCFS + (int)(rng() % (_FSCAN - _FCFS + 1));
+        int direction = (int)(rng() % 2);
+        uint64_t diskSize = rng() % 2 ? 1 + rng() % TEST_TRACKS : 0;
+        uint64_t tracks = diskSize > 0 ? diskSize : 1 + rng() % TEST_TRACKS;
+        uint64_t position = rng() % tracks;
+        int stepSize = 1 + (int)(rng() % TEST_MAX_STEP);
+        vector<uint64_t> reqs = genTracks(rng, n, tracks);
+        // 批处理
+        DiskScheduler sched(nullOutput());
+        sched.diskSize = diskSize;
+        sched.stepSize = stepSize;
+        sched.tasks = reqs;
+        sched.run(algNum, position, direction);
+        // 在线模式，所有请求在 0 时刻到达
+        onlineConfig cfg = {algNum, position, direction, diskSize, stepSize, 500.0, 5000.0, 256,
+                            model, nullptr, nullptr, nullptr};
+        vector<dTimedTask> timed(n);
+        onlineResult res;
+        for (size_t i = 0; i < n; i++) {
+            dTimedTask req = {reqs[i], 0, 0, 0, -1, 0, false, 0.0, 0.0, 0.0};
+            timed[i] = req;
+        }
+        onlineSchedule(timed, &cfg, &res);
+        if (res.order != sched.tasks || res.totalTracks != sched.totalTracks) {
+            printf("online: case %d differs (alg=%d n=%zu disk=%" PRIu64 " head=%" PRIu64 " dir=%d step=%d)\n",
+                   c, algNum, n, diskSize, position, direction, stepSize);
+            return false;
+        }
+    }
+    printf("online: %d cases passed\n", TEST_CASES);
+    return true;
+}
+
+static const testCase tests[] = {
+    {"sstf", testSSTF},
+    {"online", testOnline},
+};
+
+int main(int argc, char* argv[])
+{
+    size_t count = sizeof(tests) / sizeof(tests[0]);
+    bool passed = true;
+    for (size_t i = 0; i < count; i++) {
+        bool selected = argc < 2;
+        for (int k = 1; k < argc; k++) selected = selected || strcmp(argv[k], tests[i].name) == 0;
+        if (selected) passed = tests[i].run() && passed;
+    }
+    for (int k = 1; k < argc; k++) {
+        bool known = false;
+        for (size_t i = 0; i < count; i++) known = known || strcmp(argv[k], tests[i].name) == 0;
+        if (!known) {
+            printf("Unknown test %s\n", argv[k]);
+            passed = false;
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
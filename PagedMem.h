@@ -0,0 +1,170 @@
+/* Paged Memory Management Engine */
+#ifndef PAGED_MEM_H
+#define PAGED_MEM_H
+
+#include <cstdio>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include "TraceFormat.h"
+
+#define AGE_BUCKETS 32                          // 淘汰年龄直方图桶数（按 2 的幂划分）
+
+enum memMgmtAlg {OPT = 1, FIFO, LRU, CLOCK};    // 页面置换算法标签
+enum pageFlag {MISS = 0, HIT};                  // 页面命中标签
+enum faultClass {COLD = 0, CAPACITY, CONFLICT}; // 缺页原因标签
+
+struct residentSet {                            // 驻留集
+    long loadSeq;                               // 装入次序（OPT 在下次访问位置相同时淘汰最早装入的页面）
+    long lastUse;                               // 最近一次访问的位置（OPT）
+    int refBit;                                 // 访问位(CLOCK)
+};
+/*
+ * 页框表:
+ *  驻留集在堆上分配。各页框中的页号单独存放在对齐的连续数组 pids 中（-1 表示空闲），
+ *  命中查找用 SIMD 比较 + movemask 一次比较 4/8 个页框（OSSIM_AVX2 开启时为 8 个）；
+ *  驻留集不超过 64 页时 accessPage 按补齐后的大小分派到模板特化版本，查找内联且循环在
+ *  编译期展开。页面只在置换时离开，空闲页框总是 pids[used, pagesNum)，不需要查找。
+ *  访问时不逐页调整状态：FIFO 按装入顺序轮转淘汰，OPT 的平局按装入次序 loadSeq 决定。
+ */
+struct frameTable {
+    residentSet* frames;                        // 页框数组
+    int* pids;                                  // 各页框中的进程号（页号）
+    int capacity;                               // pids 补齐后的长度
+    int pagesNum;                               // 驻留集页面数
+    int used;                                   // 已装入的页面数
+    long loads;                                 // 累计装入次数
+    int hand;                                   // CLOCK/FIFO 指针
+    int victim;                                 // 最近一次被淘汰的页面，-1 表示没有淘汰
+};
+/*
+ * 访问序列流:
+ *  访问序列不再整体读入内存，而是边读边模拟。FIFO、LRU 和 CLOCK 只需要当前访问，
+ *  窗口容量为 1。批量模式下访问序列已在内存中（mem 非空），直接按下标读取，多个线程
+ *  共享同一份只读序列。使用 -t 指定二进制访问序列文件时（trace 非空），从内存映射文件中解码。
+ *  页号必须非负：-1 是空闲页框标记，读到负数页号时置 invalid 并结束序列。
+ *
+ * OPT 的下次访问位置（refNextUse）:
+ *  1. 内存序列和二进制序列可以重复读取，从后向前扫描一遍即可建立下次访问索引 nextDist[i]
+ *     （第 i 个访问到同一页面下一次访问的距离，0 表示不再访问），之后每次查询 O(1)，结果是
+ *     精确的。内存序列的索引由调用者用 buildNextUse 建立后传给 refInitMem，可由多个流共享；
+ *     二进制序列的索引由 refInit 建立，按 TRACE_CHUNK 个访问分块解码，存放在临时文件的
+ *     映射中，可以大于内存；距离超过 32 位的访问视为不再访问。
+ *  2. 标准输入只能读一遍，窗口中保存尚未模拟的后续 capacity 个访问，每读入一个访问就把它
+ *     接到同一页面上一次出现的后面（link），pending 记录各页面在窗口中第一次和最后一次出现的
+ *     位置。查询即取 pending 中的第一次出现，窗口外的页面视为不再访问（FAR_POSITION）。
+ */
+struct refRange {                               // 页面在前瞻窗口中的出现位置
+    long first;                                 // 第一次出现
+    long last;                                  // 最后一次出现
+};
+struct refStream {
+    FILE* in;                                   // 输入流
+    traceReader* trace;                         // 二进制访问序列
+    const int* mem;                             // 内存中的访问序列（只读，可共享）
+    long memSize;                               // 内存序列长度
+    long memPos;                                // 下一个访问在内存序列中的位置
+    long pos;                                   // 已取出的访问数，当前访问的位置为 pos - 1
+    const uint32_t* nextDist;                   // 下次访问距离索引，nullptr 表示尚未建立
+    uint32_t* ownDist;                          // 本流建立的索引
+    size_t distBytes;                           // ownDist 为文件映射时的字节数，0 表示 malloc
+    int* window;                                // 前瞻窗口（环形缓冲区）
+    long* link;                                 // 窗口中同一页面的下一次出现位置，-1 表示没有
+    std::unordered_map<int, refRange>* pending; // 窗口中各页面的出现位置（OPT）
+    long capacity;                              // 窗口容量（2 的幂）
+    long head;                                  // 下一个访问在窗口中的位置
+    long count;                                 // 窗口中已读入但尚未模拟的访问数
+    bool eof;                                   // 访问序列是否读完
+    bool invalid;                               // 是否遇到非法页号（负数或超出 int 范围）
+};
+typedef void (*pUpdateFunc)(frameTable* ft, int hitPage);
+typedef void (*pReplaceFunc)(frameTable* ft, int currPage, refStream* refs);
+struct pagePolicy {                             // 页面置换策略
+    pUpdateFunc update;                         // 更新驻留集页面
+    pReplaceFunc replace;                       // 替换驻留集页面
+    bool lookahead;                             // 是否需要前瞻窗口
+};
+struct batchJob {                               // 批量模式中的一次模拟
+    int alg;                                    // 页面置换算法序号
+    int pagesNum;                               // 驻留集页面数
+    long missTimes;                             // 缺页次数
+};
+/*
+ * 缺页统计（-s 开启）:
+ *  1. 时间线: 每 window 次访问记录一次缺页数；
+ *  2. 缺页原因: 首次访问为冷缺页(cold)；否则用同样大小的影子 LRU 判断，影子 LRU 也缺页
+ *     则为容量缺页(capacity)，影子 LRU 命中则为置换策略造成的冲突缺页(conflict)；
+ *  3. 热点页面: Space-Saving 算法，用 K 个计数器近似统计访问次数最多的 K 个页面；
+ *  4. 淘汰: 按触发淘汰的缺页原因计数，并统计被淘汰页面的驻留时间（访问数）。
+ */
+struct hotCounter {                             // Space-Saving 计数器
+    int page;                                   // 页面号
+    long count;                                 // 访问次数（上界）
+    long error;                                 // 最大高估值
+};
+struct pageStats {
+    long window;                                // 时间线采样窗口
+    int topK;                                   // 热点页面数
+    long refs;                                  // 访问次数
+    long faults;                                // 缺页次数
+    long windowFaults;                          // 当前窗口缺页次数
+    std::vector<long> timeline;                 // 缺页率时间线
+    long faultsByClass[3];                      // 各类缺页次数
+    long evictionsByClass[3];                   // 各类缺页触发的淘汰次数
+    long evictions;                             // 淘汰次数
+    long ageSum;                                // 淘汰年龄总和
+    long ageMax;                                // 最大淘汰年龄
+    long ageHist[AGE_BUCKETS];                  // 淘汰年龄直方图：桶 k 统计 [2^k, 2^(k+1))
+    std::unordered_set<int> seen;               // 访问过的页面
+    std::unordered_map<int, long> loadTime;     // 驻留页面的装入时刻
+    std::list<int> shadowLru;                   // 影子 LRU（表头为最近使用）
+    std::unordered_map<int, std::list<int>::iterator> shadowPos;
+    int shadowSize;                             // 影子 LRU 容量
+    std::vector<hotCounter> hot;                // Space-Saving 计数器
+    std::unordered_map<int, int> hotPos;        // 页面 -> 计数器下标
+};
+bool selectPolicy(int mmAlgNum, pagePolicy* policy);
+pageFlag accessPage(frameTable* ft, const pagePolicy* policy, int currPage, refStream* refs);
+bool runBatch(FILE* out, const char* algList, const char* frameList, int threads, traceReader* trace);
+void statsInit(pageStats* stats, int pagesNum, long window, int topK);
+void statsRecord(pageStats* stats, int currPage, pageFlag hitFlag, int victim);
+void statsWrite(const pageStats* stats, FILE* out, int mmAlgNum, int pagesNum);
+bool refInit(refStream* refs, FILE* in, traceReader* trace, long window);
+void refInitMem(refStream* refs, const int* mem, long size, const uint32_t* nextDist);
+void refFree(refStream* refs);
+bool refNext(refStream* refs, int* page);
+long refNextUse(refStream* refs, int page, long lastUse);
+void buildNextUse(const int* mem, long size, uint32_t* nextDist);
+frameTable* frameAlloc(int pagesNum);
+void frameFree(frameTable* ft);
+void pageAdd(frameTable* ft, int freePage, int currPage);
+void updateLRU(frameTable* ft, int hitPage);
+void updateCLOCK(frameTable* ft, int hitPage);
+void replaceOPT(frameTable* ft, int currPage, refStream* refs);
+void replaceFIFO(frameTable* ft, int currPage, refStream* refs);
+void replaceLRU(frameTable* ft, int currPage, refStream* refs);
+void replaceCLOCK(frameTable* ft, int currPage, refStream* refs);
+
+/*
+ * 页式存储管理器:
+ *  一个页框表加一种页面置换策略，状态全部在实例中，多个实例可以在不同线程中同时模拟。
+ *  OPT 需要前瞻，access 的 refs 必须是正在读取的访问序列流。currPage 必须非负。
+ */
+class PagedMemory {
+public:
+    PagedMemory();
+    ~PagedMemory();
+    bool init(int mmAlgNum, int pagesNum);      // 未知算法、页面数无效或内存不足时返回 false
+    pageFlag access(int currPage, refStream* refs);
+
+    frameTable* ft;                             // 页框表
+    pagePolicy policy;                          // 页面置换策略
+    long missTimes;                             // 缺页次数
+
+private:
+    PagedMemory(const PagedMemory&);
+    PagedMemory& operator=(const PagedMemory&);
+};
+
+#endif
@@ -0,0 +1,62 @@
+/* Process Scheduling Engine */
+#ifndef PROC_SCHED_H
+#define PROC_SCHED_H
+
+#include <cstdio>
+#include <vector>
+
+/*
+ * Process Control Block:
+ *  One entry per process, owned by a ProcScheduler instance.
+ */
+struct task_struct {
+    int pid;                // Process ID: [0, 65535]
+    int status;             // Status(Maybe enum value)
+
+    int t_arr;              // Arrival Time
+    int t_run_init;         // Initial Burst Time:          t_run_init      = t_run_exec + t_run_rest
+    int t_run_exec;         // Executed Burst Time:         t_run_exec      = t_stop - t_start
+    int t_run_rest;         // Rest Burst Time:             t_run_rest      = t_run_init - t_run_exec
+    int t_exec_start;       // Execution Start Time:        t_exec_start    = time_now()
+    int t_exec_stop;        // Execution Stop Time:         t_exec_stop     = time_now()
+
+    int order;              // Execution Order
+    int priority;           // Execution Priority
+    int slot;               // Slot
+    bool finished;          // Finished Tag
+    bool in_queue;          // Flag
+};
+
+/*
+ * Process Scheduler:
+ *  The PCB table lives in the instance instead of a global, so several schedulers can run
+ *  concurrently in one process. Every executed slice is written to `out` as
+ *  "order/pid/start/stop/priority".
+ * Scheduling Algorithms:
+ * 1. FCFS:
+ * 2. SJF:
+ * 3. SRTF:
+ * 4. RR:
+ * 5. DPSA:
+ */
+class ProcScheduler {
+public:
+    explicit ProcScheduler(FILE* out = stdout);
+    void add(int pid, int t_arr, int t_run_init, int priority, int slot);
+    bool run(int algNum);                       // false for an unknown algorithm
+
+    std::vector<task_struct> pcb_table;         // Process Control Block Table
+    int pcb_cnt;                                // PCB Counter
+
+private:
+    void FCFS();
+    void SJF();
+    void SRTF();
+    void RR();
+    void DPSA();
+    void report(const task_struct& task);
+
+    FILE* out;                                  // Output Stream
+};
+
+#endif
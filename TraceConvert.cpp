@@ -0,0 +1,131 @@
+/* Trace Converter */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+#include "OSSim.h"
+
+using namespace std;
+
+/*
+ * 访问序列格式转换:
+ *  文本 -> 二进制: ossim convert [-k pages|tracks] input.txt output.bin
+ *  二进制 -> 文本: ossim convert -d input.bin output.txt
+ *  文本格式与实验3、实验5的输入相同：以 ',' 分隔的整数，文件名为 "-" 时使用标准输入/输出。
+ *  "磁道:扇区[/到达时刻...]" 只保留磁道号；超出 int64 范围的数报错。
+ */
+static int encode(FILE* in, const char* outPath, int kind);
+static int decode(const char* inPath, FILE* out);
+
+int traceConvertMain(int argc, char* argv[])
+{
+    int kind = TRACE_PAGES;
+    bool toText = false;
+    int i = 1;
+    // 1. 读取命令行参数
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        if (strcmp(argv[i], "-d") == 0) {
+            toText = true;
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "pages") == 0) kind = TRACE_PAGES;
+            else if (strcmp(argv[i], "tracks") == 0) kind = TRACE_TRACKS;
+            else break;
+        } else {
+            break;
+        }
+    }
+    if (argc - i != 2) {
+        printf("Usage: %s [-k pages|tracks] input.txt output.bin\n       %s -d input.bin output.txt\n", argv[0], argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    // 2. 转换
+    if (toText) {
+        FILE* out = strcmp(argv[i+1], "-") == 0 ? stdout : fopen(argv[i+1], "w");
+        if (out == nullptr) {
+            printf("Cannot open %s\n", argv[i+1]);
+            exit(EXIT_FAILURE);
+        }
+        int ret = decode(argv[i], out);
+        if (out != stdout) fclose(out);
+        return ret;
+    } else {
+        FILE* in = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "r");
+        if (in == nullptr) {
+            printf("Cannot open %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+        int ret = encode(in, argv[i+1], kind);
+        if (in != stdin) fclose(in);
+        return ret;
+    }
+}
+// 文本 -> 二进制
+static int encode(FILE* in, const char* outPath, int kind)
+{
+    traceWriter tw;
+    char buf[1 << 16];
+    size_t len;
+    int64_t value = 0;
+    bool inNumber = false;
+    bool negative = false;
+    bool suffix = false;                        // 位于 ":扇区"、"/到达时刻" 等附加字段中
+    bool overflow = false;
+    if (!traceCreate(&tw, outPath, kind)) {
+        printf("Cannot open %s\n", outPath);
+        return EXIT_FAILURE;
+    }
+    // 逐块读取，遇到非数字字符即结束当前数字；序列只保存磁道号/页号，附加字段到下一个分隔符为止全部跳过
+    while (!overflow && (len = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t k = 0; k < len; k++) {
+            char c = buf[k];
+            if (c >= '0' && c <= '9') {
+                if (suffix) continue;
+                if (value > (INT64_MAX - (c - '0')) / 10) {
+                    overflow = true;
+                    break;
+                }
+                value = value * 10 + (c - '0');
+                inNumber = true;
+            } else {
+                if (inNumber) traceWrite(&tw, negative ? -value : value);
+                if (c == ':' || c == '/') suffix = true;
+                else if (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n') suffix = false;
+                negative = !suffix && c == '-';
+                value = 0;
+                inNumber = false;
+            }
+        }
+    }
+    if (inNumber && !overflow) traceWrite(&tw, negative ? -value : value);
+    if (!traceFinish(&tw, kind)) {
+        printf("Cannot write %s\n", outPath);
+        return EXIT_FAILURE;
+    }
+    if (overflow) {
+        printf("Number out of range.\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+// 二进制 -> 文本
+static int decode(const char* inPath, FILE* out)
+{
+    traceReader tr;
+    int64_t value;
+    if (!traceOpen(&tr, inPath, -1)) {
+        printf("Invalid trace file %s\n", inPath);
+        return EXIT_FAILURE;
+    }
+    for (uint64_t k = 0; traceNext(&tr, &value); k++) {
+        fprintf(out, k == 0 ? "%" PRId64 : ",%" PRId64, value);
+    }
+    fprintf(out, "\n");
+    bool complete = tr.remaining == 0;
+    traceClose(&tr);
+    if (!complete) {
+        printf("Truncated trace file %s\n", inPath);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
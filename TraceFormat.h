@@ -0,0 +1,145 @@
+/* Binary Trace Format */
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * 二进制访问序列格式:
+ *  头部 16 字节（小端）:
+ *      0   魔数 "OSTR"
+ *      4   版本号 (1)
+ *      5   序列类型: 0 页面访问序列(实验3)，1 磁道请求序列(实验5)
+ *      6   保留 (0)
+ *      8   序列长度 (uint64)
+ *  数据部分: 每个值与前一个值之差（第一个值与 0 之差）做 zigzag 编码后按 LEB128 变长存储。
+ *  相邻访问往往很接近，绝大多数值只占 1~2 个字节。
+ */
+#define TRACE_MAGIC "OSTR"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 16
+
+enum traceKind {TRACE_PAGES = 0, TRACE_TRACKS};        // 序列类型标签
+
+struct traceReader {                                    // 内存映射读取器
+    const unsigned char* base;                          // 映射起始地址
+    size_t size;                                        // 文件大小
+    const unsigned char* pos;                           // 当前读取位置
+    const unsigned char* end;                           // 映射结束地址
+    uint64_t count;                                     // 序列长度
+    uint64_t remaining;                                 // 剩余未读个数
+    int64_t prev;                                       // 上一个值
+    int kind;                                           // 序列类型
+};
+struct traceWriter {                                    // 顺序写入器
+    FILE* out;                                          // 输出文件
+    uint64_t count;                                     // 已写入个数
+    int64_t prev;                                       // 上一个值
+};
+
+// 打开并映射二进制序列文件，kind 为 -1 时不检查序列类型
+static inline bool traceOpen(traceReader* tr, const char* path, int kind)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    memset(tr, 0, sizeof(traceReader));
+    if (fd < 0) return false;
+    if (fstat(fd, &st) != 0 || st.st_size < TRACE_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+    tr->base = (const unsigned char*)addr;
+    tr->size = (size_t)st.st_size;
+    tr->end = tr->base + tr->size;
+    tr->pos = tr->base + TRACE_HEADER_SIZE;
+    tr->kind = tr->base[5];
+    for (int i = 0; i < 8; i++) tr->count |= (uint64_t)tr->base[8 + i] << (8 * i);
+    tr->remaining = tr->count;
+    // 每个值至少占 1 字节，序列长度超过数据部分字节数的头部必然损坏，调用方可以放心按 count 预分配
+    if (memcmp(tr->base, TRACE_MAGIC, 4) != 0 || tr->base[4] != TRACE_VERSION || (kind >= 0 && tr->kind != kind) ||
+        tr->count > tr->size - TRACE_HEADER_SIZE) {
+        munmap(addr, tr->size);
+        memset(tr, 0, sizeof(traceReader));
+        return false;
+    }
+    return true;
+}
+// 读取下一个值，序列结束或数据损坏时返回 false
+static inline bool traceNext(traceReader* tr, int64_t* value)
+{
+    uint64_t raw = 0;
+    int shift = 0;
+    if (tr->remaining == 0) return false;
+    for (;;) {
+        if (tr->pos >= tr->end || shift > 63) return false;
+        unsigned char byte = *tr->pos++;
+        raw |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    tr->prev += (int64_t)((raw >> 1) ^ (~(raw & 1) + 1));
+    tr->remaining--;
+    *value = tr->prev;
+    return true;
+}
+static inline void traceClose(traceReader* tr)
+{
+    if (tr->base != nullptr) munmap((void*)tr->base, tr->size);
+    memset(tr, 0, sizeof(traceReader));
+}
+
+static inline void traceWriteHeader(FILE* out, int kind, uint64_t count)
+{
+    unsigned char header[TRACE_HEADER_SIZE] = {0};
+    memcpy(header, TRACE_MAGIC, 4);
+    header[4] = TRACE_VERSION;
+    header[5] = (unsigned char)kind;
+    for (int i = 0; i < 8; i++) header[8 + i] = (unsigned char)(count >> (8 * i));
+    fwrite(header, 1, TRACE_HEADER_SIZE, out);
+}
+// 创建二进制序列文件，序列长度在关闭时回填
+static inline bool traceCreate(traceWriter* tw, const char* path, int kind)
+{
+    tw->out = fopen(path, "wb");
+    tw->count = 0;
+    tw->prev = 0;
+    if (tw->out == nullptr) return false;
+    traceWriteHeader(tw->out, kind, 0);
+    return true;
+}
+static inline void traceWrite(traceWriter* tw, int64_t value)
+{
+    unsigned char buf[10];
+    int len = 0;
+    int64_t delta = value - tw->prev;
+    uint64_t raw = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+    do {
+        buf[len] = (unsigned char)(raw & 0x7f);
+        raw >>= 7;
+        if (raw) buf[len] |= 0x80;
+        len++;
+    } while (raw);
+    fwrite(buf, 1, len, tw->out);
+    tw->prev = value;
+    tw->count++;
+}
+static inline bool traceFinish(traceWriter* tw, int kind)
+{
+    bool ok = fseek(tw->out, 0, SEEK_SET) == 0;
+    if (ok) traceWriteHeader(tw->out, kind, tw->count);
+    ok = fclose(tw->out) == 0 && ok;
+    tw->out = nullptr;
+    return ok;
+}
+
+#endif